@@ -0,0 +1,145 @@
+// Size and speed of GameArchive against the saveGame() text format: bytes per
+// game, compression time for 1, 2, 4... threads, a full scan, and random reads
+// by game number. Checks that every game reads back unchanged.
+// Usage: bench_archive [games] [max threads] [archive path]
+#include "core/GameArchive.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Moves = std::vector<std::pair<int, int>>;
+
+// Games that look like play: most moves land within two cells of one of the
+// last few, and a game ends at six in a row or after 40 to 120 moves.
+std::vector<Moves> makeGames(size_t count) {
+    std::vector<Moves> games;
+    std::mt19937 rng(17);
+    while (games.size() < count) {
+        GameBoard board;
+        Moves moves;
+        int length = 40 + static_cast<int>(rng() % 81);
+        board.makeMove(7, 7, Player::BLACK);
+        moves.emplace_back(7, 7);
+        // A game whose recent moves are boxed in ends early.
+        for (int misses = 0; misses < 50 && static_cast<int>(moves.size()) < length &&
+                             board.getGameState() == GameState::IN_PROGRESS; ++misses) {
+            const auto& near = moves[moves.size() - 1 - rng() % std::min<size_t>(moves.size(), 4)];
+            int row = near.first + static_cast<int>(rng() % 5) - 2;
+            int col = near.second + static_cast<int>(rng() % 5) - 2;
+            if (board.isValidMove(row, col) && board.makeMove(row, col, board.getCurrentPlayer())) {
+                moves.emplace_back(row, col);
+                misses = -1;
+            }
+        }
+        games.push_back(moves);
+    }
+    return games;
+}
+
+std::string toText(const Moves& moves) {
+    GameBoard board;
+    for (const auto& move : moves) board.makeMove(move.first, move.second, board.getCurrentPlayer());
+    return board.getMoveHistory();
+}
+
+// What loadGame() does to read a saved game, without the replay.
+void parseText(const std::string& text, Moves& moves) {
+    moves.clear();
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::stringstream ss(line);
+        char player;
+        int row, col;
+        if (ss >> player >> row >> col) moves.emplace_back(row, col);
+    }
+}
+
+double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    int maxThreads = argc > 2 ? std::atoi(argv[2]) : static_cast<int>(std::thread::hardware_concurrency());
+    std::string path = argc > 3 ? argv[3] : "bench_archive.c6a";
+
+    std::vector<Moves> games = makeGames(count);
+    size_t moveCount = 0;
+    std::vector<std::string> texts;
+    size_t textBytes = 0;
+    for (const Moves& game : games) {
+        moveCount += game.size();
+        texts.push_back(toText(game));
+        textBytes += texts.back().size();
+    }
+    std::cout << count << " games, " << moveCount << " moves" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    Moves moves;
+    size_t parsed = 0;
+    for (const std::string& text : texts) {
+        parseText(text, moves);
+        parsed += moves.size();
+    }
+    double textScan = seconds(start);
+    std::cout << "text      " << textBytes << " bytes, " << static_cast<double>(textBytes) / count
+              << " per game, parsed in " << textScan * 1000.0 << " ms" << std::endl;
+
+    int status = parsed == moveCount ? 0 : 1;
+    size_t archiveBytes = 0;
+    for (int threads = 1; threads <= std::max(1, maxThreads); threads *= 2) {
+        GameArchiveWriter writer(threads);
+        for (const Moves& game : games) writer.add(game);
+        start = std::chrono::steady_clock::now();
+        if (!writer.write(path)) {
+            std::cerr << "cannot write " << path << std::endl;
+            return 1;
+        }
+        archiveBytes = writer.getLastBytes();
+        std::cout << "archive   " << threads << " threads: written in " << seconds(start) * 1000.0 << " ms" << std::endl;
+    }
+    std::cout << "archive   " << archiveBytes << " bytes, " << static_cast<double>(archiveBytes) / count
+              << " per game (" << static_cast<double>(textBytes) / archiveBytes << "x smaller)" << std::endl;
+
+    GameArchiveReader reader;
+    if (!reader.open(path) || reader.size() != count) {
+        std::cerr << "cannot read " << path << std::endl;
+        return 1;
+    }
+    start = std::chrono::steady_clock::now();
+    size_t mismatches = 0;
+    bool scanned = reader.scan([&](size_t index, const Moves& read) {
+        if (read != games[index]) mismatches++;
+    });
+    double archiveScan = seconds(start);
+    std::cout << "scan      " << reader.getBlockCount() << " blocks in " << archiveScan * 1000.0 << " ms ("
+              << textScan / archiveScan << "x faster than parsing text)" << std::endl;
+
+    std::mt19937 rng(3);
+    const int reads = 10000;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reads; ++i) {
+        size_t index = rng() % count;
+        if (!reader.read(index, moves) || moves != games[index]) mismatches++;
+    }
+    std::cout << "random    " << seconds(start) * 1e6 / reads << " us per game" << std::endl;
+
+    if (!scanned || mismatches > 0) {
+        std::cout << "MISMATCH: " << mismatches << " games differ" << std::endl;
+        status = 1;
+    }
+    reader.close();
+    std::remove(path.c_str());
+    return status;
+}
@@ -0,0 +1,72 @@
+// Throughput of BatchAnalyzer against one GameAI called per position, and a
+// check that both give the same moves and scores.
+// Usage: bench_batch [positions] [max threads] [easy|medium|hard]
+#include "ai/BatchAnalyzer.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Mid-game positions: 8 to 30 stones scattered around the center.
+std::vector<std::unique_ptr<GameBoard>> makePositions(size_t count) {
+    std::vector<std::unique_ptr<GameBoard>> positions;
+    std::mt19937 rng(11);
+    while (positions.size() < count) {
+        std::unique_ptr<GameBoard> board(new GameBoard());
+        int stones = 8 + static_cast<int>(rng() % 23);
+        while (board->getMoveCount() < stones && board->getGameState() == GameState::IN_PROGRESS) {
+            board->makeMove(3 + rng() % 9, 3 + rng() % 9, board->getCurrentPlayer());
+        }
+        if (board->getGameState() == GameState::IN_PROGRESS) positions.push_back(std::move(board));
+    }
+    return positions;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200;
+    int maxThreads = argc > 2 ? std::atoi(argv[2]) : static_cast<int>(std::thread::hardware_concurrency());
+    AIDifficulty difficulty = AIDifficulty::EASY;
+    if (argc > 3 && std::strcmp(argv[3], "medium") == 0) difficulty = AIDifficulty::MEDIUM;
+    if (argc > 3 && std::strcmp(argv[3], "hard") == 0) difficulty = AIDifficulty::HARD;
+
+    std::vector<std::unique_ptr<GameBoard>> boards = makePositions(count);
+    std::vector<const GameBoard*> positions;
+    for (const auto& board : boards) positions.push_back(board.get());
+
+    // Baseline: what a caller without the batch API does, a fresh GameAI per position.
+    std::vector<ScoredMove> expected;
+    auto start = std::chrono::steady_clock::now();
+    for (const GameBoard* board : positions) {
+        GameAI ai;
+        ai.setVerbose(false);
+        ai.setDifficulty(difficulty);
+        expected.push_back(ai.getScoredMove(*board, board->getCurrentPlayer()));
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "single calls      " << count / seconds << " positions/s" << std::endl;
+
+    int status = 0;
+    for (int threads = 1; threads <= std::max(1, maxThreads); threads *= 2) {
+        BatchAnalyzer batch(threads);
+        batch.setDifficulty(difficulty);
+        std::vector<ScoredMove> results = batch.analyze(positions);
+        const BatchStats& stats = batch.getLastStats();
+
+        size_t mismatches = 0;
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (results[i].move != expected[i].move || results[i].score != expected[i].score) mismatches++;
+        }
+        if (mismatches) status = 1;
+        std::cout << "batch, " << threads << " thread(s) " << stats.positionsPerSecond << " positions/s, "
+                  << mismatches << " mismatches" << std::endl;
+    }
+    return status;
+}
@@ -0,0 +1,68 @@
+// Cost of one search leaf for each evaluator: make a move, evaluate the
+// result, take the move back. Usage: bench_eval [weights file] [iterations]
+#include "ai/NNUEEvaluator.h"
+#include "ai/PatternEvaluator.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+volatile long long sink;
+
+std::shared_ptr<const NNUEWeights> randomWeights() {
+    auto weights = std::make_shared<NNUEWeights>();
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> value(-20, 20);
+    for (auto& row : weights->features) {
+        for (auto& w : row) w = static_cast<int16_t>(value(rng));
+    }
+    for (auto& w : weights->hiddenBias) w = static_cast<int16_t>(value(rng));
+    for (auto& w : weights->output) w = static_cast<int16_t>(value(rng));
+    return weights;
+}
+
+double nanosecondsPerLeaf(Evaluator& evaluator, GameBoard& board, int iterations) {
+    std::vector<std::pair<int, int>> moves = board.getValidMoves();
+    evaluator.reset(board);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        const auto& move = moves[i % moves.size()];
+        Player player = board.getCurrentPlayer();
+        board.makeMove(move.first, move.second, player);
+        evaluator.onMakeMove(move.first, move.second, player);
+        sink = sink + evaluator.evaluate(board, player);
+        board.undoMove();
+        evaluator.onUndoMove(move.first, move.second, player);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::shared_ptr<const NNUEWeights> weights = argc > 1 ? NNUEWeights::load(argv[1]) : randomWeights();
+    if (!weights) {
+        std::cerr << "failed to load " << argv[1] << std::endl;
+        return 1;
+    }
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 200000;
+
+    // A middle-game position: 30 stones around the center.
+    GameBoard board;
+    std::mt19937 rng(7);
+    while (board.getMoveCount() < 30 && board.getGameState() == GameState::IN_PROGRESS) {
+        board.makeMove(3 + rng() % 9, 3 + rng() % 9, board.getCurrentPlayer());
+    }
+
+    NNUEEvaluator nnue(weights);
+    PatternEvaluator patterns;
+    std::cout << "nnue     " << nanosecondsPerLeaf(nnue, board, iterations) << " ns/leaf" << std::endl;
+    std::cout << "patterns " << nanosecondsPerLeaf(patterns, board, iterations / 100 + 1) << " ns/leaf" << std::endl;
+    return 0;
+}
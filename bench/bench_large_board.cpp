@@ -0,0 +1,167 @@
+// GameBoard-style dense boards against SparseBoard on boards from 15x15 to
+// 59x59 (and unbounded), with the same stones on each. Times candidate
+// generation and a make-evaluate-undo step, and checks that both evaluations
+// agree.
+//
+// The dense board stands for the engine as it is: a row-major cell array,
+// every empty cell a candidate (GameAI::getPossibleMoves()) and an evaluation
+// that scans the whole board.
+// Usage: bench_large_board [stones] [iterations]
+#include "core/SparseBoard.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+class DenseBoard {
+public:
+    explicit DenseBoard(int size) : size(size), cells(static_cast<size_t>(size) * size, Player::NONE) {}
+
+    void set(int row, int col, Player player) { cells[static_cast<size_t>(row) * size + col] = player; }
+
+    int candidates(std::vector<std::pair<int, int>>& out) const {
+        out.clear();
+        for (int row = 0; row < size; ++row) {
+            for (int col = 0; col < size; ++col) {
+                if (cells[static_cast<size_t>(row) * size + col] == Player::NONE) out.emplace_back(row, col);
+            }
+        }
+        return static_cast<int>(out.size());
+    }
+
+    // Same window scores as SparseBoard, over every window on the board.
+    int64_t evaluate(Player player) const {
+        static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+        int64_t scores[3] = {0, 0, 0};
+        for (int row = 0; row < size; ++row) {
+            for (int col = 0; col < size; ++col) {
+                for (const auto& d : directions) {
+                    int endRow = row + (SparseBoard::WIN_LENGTH - 1) * d[0];
+                    int endCol = col + (SparseBoard::WIN_LENGTH - 1) * d[1];
+                    if (endRow >= size || endCol < 0 || endCol >= size) continue;
+                    int counts[3] = {0, 0, 0};
+                    for (int i = 0; i < SparseBoard::WIN_LENGTH; ++i) {
+                        counts[static_cast<int>(cells[static_cast<size_t>(row + i * d[0]) * size + col + i * d[1]])]++;
+                    }
+                    if (counts[1] && !counts[2]) scores[1] += SparseBoard::WINDOW_SCORES[counts[1]];
+                    if (counts[2] && !counts[1]) scores[2] += SparseBoard::WINDOW_SCORES[counts[2]];
+                }
+            }
+        }
+        int own = static_cast<int>(player);
+        return scores[own] - scores[3 - own];
+    }
+
+private:
+    int size;
+    std::vector<Player> cells;
+};
+
+// `count` stones around the middle of a `size` board, as a game spreads.
+std::vector<std::pair<int, int>> makeStones(int size, int count, SparseBoard& probe) {
+    std::mt19937 rng(9);
+    std::vector<std::pair<int, int>> stones;
+    int center = size / 2;
+    std::pair<int, int> last(center, center);
+    while (static_cast<int>(stones.size()) < count && probe.getGameState() == GameState::IN_PROGRESS) {
+        int row = last.first + static_cast<int>(rng() % 5) - 2;
+        int col = last.second + static_cast<int>(rng() % 5) - 2;
+        if (probe.makeMove(row, col)) {
+            stones.emplace_back(row, col);
+            last = stones[rng() % stones.size()];
+        }
+    }
+    return stones;
+}
+
+double nanoseconds(std::chrono::steady_clock::time_point start, int iterations) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int stoneCount = argc > 1 ? std::atoi(argv[1]) : 60;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 2000;
+
+    std::cout << " size   dense cand   ns/gen  ns/step   sparse cand   ns/gen  ns/step  chunks" << std::endl;
+    int status = 0;
+    for (int size : {15, 19, 29, 39, 59, SparseBoard::UNBOUNDED}) {
+        // The same shape on every board: stones placed from the center of a
+        // 15x15 area, shifted to the middle of the larger ones.
+        SparseBoard probe(15);
+        std::vector<std::pair<int, int>> stones = makeStones(15, stoneCount, probe);
+        // Unbounded, they sit around (0, 0); the dense board then only checks
+        // the evaluation, on a 59x59 board whose edges no window reaches.
+        bool unbounded = size == SparseBoard::UNBOUNDED;
+        int shift = unbounded ? -7 : (size - 15) / 2;
+        int denseShift = unbounded ? 22 : shift;
+
+        SparseBoard sparse(size);
+        DenseBoard dense(unbounded ? 59 : size);
+        for (const auto& stone : stones) {
+            Player player = sparse.getCurrentPlayer();
+            sparse.makeMove(stone.first + shift, stone.second + shift);
+            dense.set(stone.first + denseShift, stone.second + denseShift, player);
+        }
+        Player toMove = sparse.getCurrentPlayer();
+        if (dense.evaluate(toMove) != sparse.evaluate(toMove)) {
+            std::cout << "MISMATCH on size " << size << ": dense " << dense.evaluate(toMove) << ", sparse "
+                      << sparse.evaluate(toMove) << std::endl;
+            status = 1;
+        }
+
+        std::vector<std::pair<int, int>> cells;
+        int64_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) sink += dense.candidates(cells);
+        double denseGen = nanoseconds(start, iterations);
+        size_t denseCount = cells.size();
+        // A search step: play a candidate, evaluate, take it back.
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            const auto& cell = cells[i % cells.size()];
+            dense.set(cell.first, cell.second, toMove);
+            sink += dense.evaluate(toMove);
+            dense.set(cell.first, cell.second, Player::NONE);
+        }
+        double denseStep = nanoseconds(start, iterations);
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            sparse.getCandidates(cells);
+            sink += static_cast<int64_t>(cells.size());
+        }
+        double sparseGen = nanoseconds(start, iterations);
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            const auto& cell = cells[i % cells.size()];
+            sparse.makeMove(cell.first, cell.second);
+            sink += sparse.evaluate(toMove);
+            sparse.undoMove();
+        }
+        double sparseStep = nanoseconds(start, iterations);
+
+        std::cout.width(5);
+        std::cout << (unbounded ? std::string("inf") : std::to_string(size));
+        std::cout.width(13);
+        std::cout << (unbounded ? std::string("-") : std::to_string(denseCount));
+        std::cout.width(9);
+        std::cout << (unbounded ? std::string("-") : std::to_string(static_cast<int>(denseGen)));
+        std::cout.width(9);
+        std::cout << (unbounded ? std::string("-") : std::to_string(static_cast<int>(denseStep)));
+        std::cout.width(14);
+        std::cout << cells.size();
+        std::cout.width(9);
+        std::cout << static_cast<int>(sparseGen);
+        std::cout.width(9);
+        std::cout << static_cast<int>(sparseStep);
+        std::cout.width(8);
+        std::cout << sparse.getChunkCount() << std::endl;
+        if (sink == 42) std::cout << std::endl;     // keeps the loops from being optimized out
+    }
+    return status;
+}
@@ -0,0 +1,87 @@
+// Cost of multi-PV analysis against single-line analysis of the same
+// positions. Every search starts from an empty table, so each row times the
+// same work; the positions come from an Easy self-play game.
+// Usage: bench_multipv [positions] [depth]
+#include "ai/GameAI.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace {
+
+const int OPENING_MOVES = 6;
+
+struct Totals {
+    double ms = 0.0;
+    uint64_t nodes = 0;
+    uint64_t researches = 0;
+};
+
+std::vector<std::unique_ptr<GameBoard>> makePositions(int count) {
+    GameAI player;
+    player.setVerbose(false);
+    player.setSeed(3);
+    player.setDifficulty(AIDifficulty::EASY);
+    std::vector<std::unique_ptr<GameBoard>> positions;
+    GameBoard board;
+    while (static_cast<int>(positions.size()) < count && board.getGameState() == GameState::IN_PROGRESS) {
+        std::pair<int, int> move = player.getBestMove(board, board.getCurrentPlayer());
+        board.makeMove(move.first, move.second, board.getCurrentPlayer());
+        // The opening is skipped: every search there is short.
+        if (board.getMoveCount() > OPENING_MOVES && board.getGameState() == GameState::IN_PROGRESS) {
+            positions.emplace_back(new GameBoard());
+            *positions.back() = board;
+        }
+    }
+    return positions;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 20;
+    int depth = argc > 2 ? std::atoi(argv[2]) : 3;
+    std::vector<std::unique_ptr<GameBoard>> positions = makePositions(count);
+
+    GameAI ai;
+    ai.setVerbose(false);
+    ai.setSeed(1);
+    std::cout << positions.size() << " positions, depth " << depth << std::endl;
+    std::cout << " lines        ms     nodes  re-searched  vs 1 line" << std::endl;
+    uint64_t singleNodes = 0;
+    int mismatches = 0;
+    for (int lines : {1, 2, 3, 5, 8}) {
+        Totals totals;
+        for (size_t i = 0; i < positions.size(); ++i) {
+            const GameBoard& board = *positions[i];
+            ai.newGame();
+            auto start = std::chrono::steady_clock::now();
+            AnalysisInfo info = ai.analyze(board, board.getCurrentPlayer(), depth, lines);
+            totals.ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            totals.nodes += ai.getLastSearchStats().nodes;
+            totals.researches += ai.getLastSearchStats().rootResearches;
+            // Every line count must agree on the best score and give one PV per move.
+            ai.newGame();
+            AnalysisInfo single = ai.analyze(board, board.getCurrentPlayer(), depth, 1);
+            if (info.bestMoves.front().score != single.bestMoves.front().score
+                || info.pvs.size() != info.bestMoves.size()) {
+                mismatches++;
+            }
+        }
+        if (lines == 1) singleNodes = totals.nodes;
+        std::cout.width(6);
+        std::cout << lines;
+        std::cout.width(10);
+        std::cout << static_cast<int64_t>(totals.ms);
+        std::cout.width(10);
+        std::cout << totals.nodes;
+        std::cout.width(13);
+        std::cout << totals.researches;
+        std::cout.width(10);
+        std::cout << static_cast<double>(totals.nodes) / singleNodes << "x" << std::endl;
+    }
+    if (mismatches) std::cout << mismatches << " searches disagree with the single-line score" << std::endl;
+    return mismatches ? 1 : 0;
+}
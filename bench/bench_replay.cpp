@@ -0,0 +1,90 @@
+// Cost of putting a board at a ply of a long game: replaying the game from
+// the empty board, as loading and repeated undo do, against
+// GameTimeline::seek(), for random jumps and for scrubbing one ply at a time.
+// Checks that every seek lands on the replayed position.
+// Usage: bench_replay [jumps]
+#include "core/GameTimeline.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+// A random game of at least `minMoves` moves.
+std::vector<std::pair<int, int>> makeGame(int minMoves) {
+    for (unsigned seed = 1;; ++seed) {
+        std::vector<int> cells(GameBoard::BOARD_SIZE * GameBoard::BOARD_SIZE);
+        std::iota(cells.begin(), cells.end(), 0);
+        std::shuffle(cells.begin(), cells.end(), std::mt19937(seed));
+        GameBoard game;
+        std::vector<std::pair<int, int>> moves;
+        for (int cell : cells) {
+            if (game.getGameState() != GameState::IN_PROGRESS) break;
+            moves.emplace_back(cell / GameBoard::BOARD_SIZE, cell % GameBoard::BOARD_SIZE);
+            game.makeMove(moves.back().first, moves.back().second, game.getCurrentPlayer());
+        }
+        if (static_cast<int>(moves.size()) >= minMoves) return moves;
+    }
+}
+
+void replay(GameBoard& board, const std::vector<std::pair<int, int>>& moves, int ply) {
+    board.reset();
+    for (int i = 0; i < ply; ++i) board.makeMove(moves[i].first, moves[i].second, board.getCurrentPlayer());
+}
+
+// Nanoseconds per target; false if a position differs from `expected`.
+bool measure(const char* name, const std::vector<int>& targets, const std::vector<uint64_t>& expected,
+             const std::function<void(GameBoard&, int)>& seek) {
+    GameBoard board;
+    bool ok = true;
+    auto start = std::chrono::steady_clock::now();
+    for (int ply : targets) {
+        seek(board, ply);
+        if (board.getHash() != expected[ply] || board.getMoveCount() != ply) ok = false;
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ns / targets.size() << " ns per seek" << (ok ? "" : "  MISMATCH") << std::endl;
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int jumps = argc > 1 ? std::atoi(argv[1]) : 20000;
+    std::vector<std::pair<int, int>> moves = makeGame(200);
+    const int size = static_cast<int>(moves.size());
+
+    GameBoard game;
+    std::vector<uint64_t> expected(1, game.getHash());
+    for (const auto& move : moves) {
+        game.makeMove(move.first, move.second, game.getCurrentPlayer());
+        expected.push_back(game.getHash());
+    }
+    GameTimeline timeline;
+    timeline.sync(game);
+    std::cout << "game of " << size << " moves, snapshot every " << GameTimeline::SNAPSHOT_INTERVAL << std::endl;
+
+    std::mt19937 rng(5);
+    std::vector<int> random(jumps);
+    for (int& ply : random) ply = static_cast<int>(rng() % (size + 1));
+    // Scrubbing: back to the start and forward to the end, one ply at a time.
+    std::vector<int> scrub;
+    while (static_cast<int>(scrub.size()) < jumps) {
+        for (int ply = size; ply >= 0; --ply) scrub.push_back(ply);
+        for (int ply = 1; ply < size; ++ply) scrub.push_back(ply);
+    }
+
+    auto byReplay = [&moves](GameBoard& board, int ply) { replay(board, moves, ply); };
+    auto byTimeline = [&timeline](GameBoard& board, int ply) { timeline.seek(board, ply); };
+    bool ok = true;
+    ok &= measure("random jumps, replay     ", random, expected, byReplay);
+    ok &= measure("random jumps, timeline   ", random, expected, byTimeline);
+    ok &= measure("scrubbing, replay        ", scrub, expected, byReplay);
+    ok &= measure("scrubbing, timeline      ", scrub, expected, byTimeline);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+// Probe/store throughput of one TranspositionTable shared by several threads,
+// lockless against the same table behind a mutex, and the latency of probes
+// into a table far larger than the caches with and without a prefetch.
+//
+// Every stored entry is derived from its key, so a probe that returns an
+// entry not matching its key (a torn write read back) is counted.
+// Usage: bench_tt [megabytes] [max threads] [operations per thread]
+#include "ai/TranspositionTable.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Keys repeat, as positions do in a search: a quarter of the operations go
+// to a small set shared by all threads.
+const uint64_t SHARED_KEYS = 4096;
+const int PREFETCH_DISTANCE = 8;
+
+uint64_t mix(uint64_t value) {
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+int scoreOf(uint64_t key) {
+    return static_cast<int32_t>(key >> 32);
+}
+
+int moveOf(uint64_t key) {
+    return static_cast<int>(key % 225);
+}
+
+struct Result {
+    double seconds = 0.0;
+    uint64_t hits = 0;
+    uint64_t corrupt = 0;
+};
+
+// Each thread probes and, on a miss, stores; about one operation in five is a store.
+template <typename Probe, typename Store>
+Result run(int threads, uint64_t operations, uint64_t seed, Probe probe, Store store) {
+    std::vector<std::thread> workers;
+    std::atomic<uint64_t> hits(0), corrupt(0);
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            uint64_t threadHits = 0, threadCorrupt = 0;
+            uint64_t state = mix(seed * 1000 + t);
+            for (uint64_t i = 0; i < operations; ++i) {
+                state = mix(state + i);
+                uint64_t key = (state & 3) == 0 ? mix(state % SHARED_KEYS) : state;
+                TranspositionTable::Entry entry;
+                if (probe(key, entry)) {
+                    threadHits++;
+                    if (entry.score != scoreOf(key) || entry.move != moveOf(key)) threadCorrupt++;
+                } else {
+                    store(key);
+                }
+            }
+            hits += threadHits;
+            corrupt += threadCorrupt;
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+    Result result;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.hits = hits;
+    result.corrupt = corrupt;
+    return result;
+}
+
+double probeNanoseconds(TranspositionTable& table, const std::vector<uint64_t>& keys, bool prefetch) {
+    TranspositionTable::Entry entry;
+    uint64_t found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (prefetch && i + PREFETCH_DISTANCE < keys.size()) table.prefetch(keys[i + PREFETCH_DISTANCE]);
+        found += table.probe(keys[i], entry);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    if (found == 42) std::cout << std::endl;     // keeps the probes from being optimized out
+    return ns / keys.size();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 256;
+    int maxThreads = argc > 2 ? std::atoi(argv[2]) : std::max(4, static_cast<int>(std::thread::hardware_concurrency()));
+    uint64_t operations = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 2000000;
+
+    TranspositionTable table;
+    table.setMegabytes(megabytes);
+    std::cout << table.getBytes() / (1 << 20) << " MB table, " << table.getEntries() << " entries, "
+              << std::thread::hardware_concurrency() << " cores" << std::endl;
+
+    // The threads' first stores race on an empty table: none may tear.
+    auto store = [&](uint64_t key) {
+        table.store(key, scoreOf(key), 8, TranspositionTable::EXACT, moveOf(key));
+    };
+    auto probe = [&](uint64_t key, TranspositionTable::Entry& entry) { return table.probe(key, entry); };
+    Result empty = run(maxThreads, operations / 8, 0, probe, store);
+    std::cout << maxThreads << " threads from an empty table: " << empty.corrupt << " corrupt" << std::endl;
+    int status = empty.corrupt ? 1 : 0;
+
+    // Then fill it, so no timed run pays for the page faults.
+    table.clear();
+    std::vector<uint64_t> keys(table.getEntries() / 2);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        keys[i] = mix(i + 12345);
+        table.store(keys[i], scoreOf(keys[i]), 8, TranspositionTable::EXACT, moveOf(keys[i]));
+    }
+
+    std::cout << "threads  lockless Mops/s  mutex Mops/s  hits  corrupt" << std::endl;
+    uint64_t seed = 0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        Result lockless = run(threads, operations, ++seed, probe, store);
+
+        std::mutex mutex;
+        Result locked = run(threads, operations, ++seed,
+                            [&](uint64_t key, TranspositionTable::Entry& entry) {
+                                std::lock_guard<std::mutex> lock(mutex);
+                                return table.probe(key, entry);
+                            },
+                            [&](uint64_t key) {
+                                std::lock_guard<std::mutex> lock(mutex);
+                                store(key);
+                            });
+
+        double total = static_cast<double>(operations) * threads / 1e6;
+        std::cout.width(7);
+        std::cout << threads;
+        std::cout.width(17);
+        std::cout << static_cast<int>(total / lockless.seconds);
+        std::cout.width(14);
+        std::cout << static_cast<int>(total / locked.seconds);
+        std::cout.width(6);
+        std::cout << static_cast<int>(100.0 * lockless.hits / (operations * threads)) << "%";
+        std::cout.width(9);
+        std::cout << lockless.corrupt << std::endl;
+        if (lockless.corrupt || locked.corrupt) status = 1;
+    }
+
+    // Probes of the filled keys at random: nearly every one misses the caches.
+    keys.resize(std::min<size_t>(keys.size(), operations));
+    for (size_t i = 0; i < keys.size(); ++i) keys[i] = keys[mix(i) % keys.size()];
+    double plain = probeNanoseconds(table, keys, false);
+    double fetched = probeNanoseconds(table, keys, true);
+    std::cout << "random probes: " << plain << " ns, " << fetched << " ns with prefetch " << PREFETCH_DISTANCE
+              << " ahead (fill " << table.getFill() << ")" << std::endl;
+    return status;
+}
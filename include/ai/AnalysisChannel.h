@@ -0,0 +1,29 @@
+#ifndef ANALYSISCHANNEL_H
+#define ANALYSISCHANNEL_H
+
+#include <cstdint>
+#include <mutex>
+#include "ai/GameAI.h"
+
+// Hands the latest AnalysisInfo from a search thread to a consumer that polls
+// at its own pace. Only the newest update is kept, so a search publishing
+// hundreds of updates per second never queues work for the UI thread.
+class AnalysisChannel {
+public:
+    void publish(const AnalysisInfo& info);
+    // Copies the newest update into `info`; false if nothing arrived since the last take().
+    bool take(AnalysisInfo& info);
+    void clear();
+
+    uint64_t getPublished() const;
+    uint64_t getDelivered() const;
+
+private:
+    mutable std::mutex mutex;
+    AnalysisInfo latest;
+    bool fresh = false;
+    uint64_t published = 0;
+    uint64_t delivered = 0;
+};
+
+#endif // ANALYSISCHANNEL_H
@@ -0,0 +1,42 @@
+#ifndef BACKGROUNDSEARCH_H
+#define BACKGROUNDSEARCH_H
+
+#include <functional>
+#include <thread>
+#include <utility>
+#include "ai/AnalysisChannel.h"
+#include "ai/GameAI.h"
+#include "core/GameBoard.h"
+
+// Runs an AI's move search on a background thread, so the window keeps
+// painting while it thinks. The search's root scores and principal
+// variation are published to a channel as it runs, so an analysis view shows
+// the search that actually decides the move, not a second one beside it.
+//
+// While a search runs the background thread owns the GameAI; cancel() it, or
+// wait for `done`, before using that engine from any other thread.
+class BackgroundSearch {
+public:
+    // Called on the search thread with the chosen move.
+    using DoneCallback = std::function<void(std::pair<int, int>)>;
+
+    BackgroundSearch();
+    ~BackgroundSearch();
+
+    // Searches `board` for the side to move; `channel` may be nullptr.
+    void start(GameAI& ai, const GameBoard& board, AnalysisChannel* channel, const DoneCallback& done);
+    // Stops a running search, without calling `done`, and joins the thread.
+    void cancel();
+    bool isActive() const;
+
+private:
+    void run();
+
+    GameAI* ai;
+    GameBoard position;
+    AnalysisChannel* channel;
+    DoneCallback done;
+    std::thread worker;
+};
+
+#endif // BACKGROUNDSEARCH_H
@@ -0,0 +1,42 @@
+#ifndef BATCHANALYZER_H
+#define BATCHANALYZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ai/GameAI.h"
+#include "core/GameBoard.h"
+
+struct BatchStats {
+    size_t positions = 0;
+    int threads = 0;
+    int64_t elapsedMs = 0;
+    double positionsPerSecond = 0.0;
+};
+
+// Best move and score for many positions at once. Each thread keeps one
+// GameAI for the analyzer's lifetime, so weights, search arenas and node pools
+// are set up once rather than per position, and threads take positions from a
+// shared counter so uneven search times balance out. Every result equals
+// GameAI::getScoredMove() on that position with the same settings.
+class BatchAnalyzer {
+public:
+    explicit BatchAnalyzer(int threads = 0);
+
+    void setDifficulty(AIDifficulty difficulty);
+    void setEngine(AIEngine engine);
+    int getThreadCount() const;
+
+    // Searches positions[i] for its side to move into results[i]; finished
+    // positions get move (-1, -1).
+    void analyze(const GameBoard* const* positions, size_t count, ScoredMove* results);
+    std::vector<ScoredMove> analyze(const std::vector<const GameBoard*>& positions);
+    const BatchStats& getLastStats() const;
+
+private:
+    std::vector<std::unique_ptr<GameAI>> engines;
+    BatchStats lastStats;
+};
+
+#endif // BATCHANALYZER_H
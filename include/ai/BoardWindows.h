@@ -0,0 +1,65 @@
+#ifndef BOARDWINDOWS_H
+#define BOARDWINDOWS_H
+
+#include <cstdint>
+#include "core/GameBoard.h"
+#include "core/Player.h"
+
+// Every six-cell window that fits on the board, for the engine parts that
+// keep stone counts per window: ThreatGenerator, ProofSolver and
+// NNUEEvaluator. Windows are numbered by direction (row, column, diagonal,
+// anti-diagonal), then by the row and column of their first cell; trained
+// NNUE weights depend on that order.
+class BoardWindows {
+public:
+    static const int CELLS = GameBoard::BOARD_SIZE * GameBoard::BOARD_SIZE;
+    static const int COUNT = 2 * GameBoard::BOARD_SIZE * (GameBoard::BOARD_SIZE - GameBoard::WIN_LENGTH + 1)
+                           + 2 * (GameBoard::BOARD_SIZE - GameBoard::WIN_LENGTH + 1)
+                               * (GameBoard::BOARD_SIZE - GameBoard::WIN_LENGTH + 1);
+    static const int MAX_PER_CELL = 4 * GameBoard::WIN_LENGTH;
+
+    // The windows through one cell, for range-for.
+    struct Range {
+        const int16_t* first;
+        const int16_t* last;
+        const int16_t* begin() const { return first; }
+        const int16_t* end() const { return last; }
+    };
+
+    static const BoardWindows& get();
+
+    // Window index to its cells, as row * BOARD_SIZE + col.
+    int16_t cells[COUNT][GameBoard::WIN_LENGTH];
+
+    Range windowsOf(int cell) const {
+        return Range{windowsOfCell[cell], windowsOfCell[cell] + windowCount[cell]};
+    }
+
+private:
+    BoardWindows();
+
+    int16_t windowsOfCell[CELLS][MAX_PER_CELL];
+    uint8_t windowCount[CELLS];
+};
+
+// Index of a colour in per-colour tables: 0 for black, 1 for white.
+inline int colorIndex(Player player) {
+    return player == Player::BLACK ? 0 : 1;
+}
+
+// Stones of each colour in every window, indexed [colorIndex][window]. Its
+// owner keeps it in step with the board on every make and undo.
+class WindowStones {
+public:
+    void clear();
+    // Counts the stones of `board`.
+    void reset(const GameBoard& board);
+
+    uint8_t* operator[](int color) { return counts[color]; }
+    const uint8_t* operator[](int color) const { return counts[color]; }
+
+private:
+    uint8_t counts[2][BoardWindows::COUNT];
+};
+
+#endif // BOARDWINDOWS_H
@@ -0,0 +1,20 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include "core/GameBoard.h"
+#include "core/Player.h"
+
+// Static evaluation used at the leaves of the minimax search. The search
+// calls reset() on the root position and reports every move it makes and
+// takes back, so implementations can keep incremental state.
+class Evaluator {
+public:
+    virtual ~Evaluator() = default;
+
+    virtual void reset(const GameBoard& board) { (void)board; }
+    virtual void onMakeMove(int row, int col, Player player) { (void)row; (void)col; (void)player; }
+    virtual void onUndoMove(int row, int col, Player player) { (void)row; (void)col; (void)player; }
+    virtual int evaluate(const GameBoard& board, Player player) = 0;
+};
+
+#endif // EVALUATOR_H
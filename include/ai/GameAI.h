@@ -5,9 +5,21 @@
 #include <vector>
 #include <utility>
 #include <random>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <functional>
 #include "core/GameBoard.h"
 #include "core/Player.h"
 #include "core/GameState.h"
+#include "ai/ProofSolver.h"
+#include "ai/MCTSEngine.h"
+#include "ai/SearchArena.h"
+#include "ai/PatternEvaluator.h"
+#include "ai/NNUEEvaluator.h"
+#include "ai/SearchTrace.h"
+#include "ai/ThreatGenerator.h"
+#include "ai/TranspositionTable.h"
 
 enum class AIDifficulty {
     EASY,
@@ -15,27 +27,200 @@ enum class AIDifficulty {
     HARD     
 };
 
+enum class AIEngine {
+    MINIMAX,
+    MCTS
+};
+
+// Progress of GameAI::analyze() at one depth.
+struct AnalysisInfo {
+    int depth = 0;
+    int searchedMoves = 0;              // root moves finished at this depth
+    int totalMoves = 0;
+    std::vector<ScoredMove> bestMoves;  // best first, exact scores; ties keep the root move order
+    std::vector<ScoredMove> rootMoves;  // every move searched so far; outside the top list the score is an upper bound
+    std::vector<std::pair<int, int>> pv;  // principal variation of the best move
+    std::vector<std::vector<std::pair<int, int>>> pvs;  // pvs[i] is the line of bestMoves[i]
+};
+
+using AnalysisCallback = std::function<void(const AnalysisInfo&)>;
+
+// Work done by the last getScoredMove()/getBestMove() or analyze() call.
+struct SearchStats {
+    uint64_t nodes = 0;             // minimax calls, leaves and quiescence nodes included
+    uint64_t quiescenceNodes = 0;   // nodes past the horizon resolving threats
+    uint64_t solverNodes = 0;
+    uint64_t tableProbes = 0;       // minimax transposition table
+    uint64_t tableHits = 0;
+    uint64_t solverTableProbes = 0;
+    uint64_t solverTableHits = 0;
+    uint64_t lmrReductions = 0;     // quiet moves searched at reduced depth
+    uint64_t lmrResearches = 0;     // ... and searched again because they beat alpha
+    uint64_t rootResearches = 0;    // analyze() root moves that beat the N-th best's null window
+    uint64_t lateMovesPruned = 0;
+    uint64_t futilityPruned = 0;
+    int64_t elapsedUs = 0;
+};
+
+// Selective search for the minimax engine. Moves that make or stop a six,
+// five or open four are forcing and never reduced or pruned; the first move
+// of every node is always searched in full.
+struct SelectiveSearch {
+    bool enabled = true;
+    // Searches shallower than this stay exhaustive, so Easy and Medium play
+    // exactly as before and only Hard trades width for depth.
+    int minDepth = 5;
+    // Late move reductions: in nodes at least lmrMinDepth deep, quiet moves
+    // after the first lmrFullDepthMoves are searched lmrReduction plies
+    // shallower with a null window, then at full depth if they beat alpha.
+    int lmrMinDepth = 3;
+    int lmrFullDepthMoves = 3;
+    int lmrReduction = 2;
+    // Late move pruning: a node `depth` plies above the leaves searches at
+    // most lmpBaseMoves + lmpMovesPerDepth * depth quiet moves.
+    int lmpBaseMoves = 4;
+    int lmpMovesPerDepth = 2;
+    // Futility pruning: one ply above the leaves, quiet moves are skipped when
+    // the static evaluation plus this margin does not reach alpha.
+    int futilityMargin = 30000;
+};
+
 class GameAI : public QObject {
     Q_OBJECT
 
 public:
+    // Above any evaluation; a win found `ply` moves deep scores WIN_SCORE - ply.
+    static const int WIN_SCORE = 1000000000;
+
     explicit GameAI(QObject* parent = nullptr);
     std::pair<int, int> getBestMove(const GameBoard& board, Player player);
+    // getBestMove() with the minimax score for `player`: WIN_SCORE for a
+    // solver-proven win, 0 for a proven draw and for the MCTS engine.
+    ScoredMove getScoredMove(const GameBoard& board, Player player);
+    // Iterative deepening up to maxDepth that scores the best `topMoves` root
+    // moves exactly, each with its principal variation (multi-PV). `callback`
+    // sees the list after every root move; the result is the last depth that
+    // finished before a stop request.
+    AnalysisInfo analyze(const GameBoard& board, Player player, int maxDepth, int topMoves,
+                         const AnalysisCallback& callback = AnalysisCallback());
+    // A different difficulty clears the transposition table, so Easy and
+    // Medium never cut off on the results of a pruned Hard search.
     void setDifficulty(AIDifficulty difficulty);
     AIDifficulty getDifficulty() const;
+    void setEngine(AIEngine engine);
+    AIEngine getEngine() const;
+    // Playout and time limits for MCTS searches in place of the
+    // difficulty's; 0 keeps the difficulty's limit. A stop request ends the
+    // search either way.
+    void setMCTSLimits(uint64_t maxPlayouts, int maxTimeMs);
+    // Per-move search reports on stdout; on by default.
+    void setVerbose(bool enabled);
+    // Deterministic mode: random choices use `seed` and MCTS runs on one
+    // thread with only its playout budget, so equal inputs give equal moves.
+    // CONNECT6_SEED in the environment enables it for every GameAI.
+    void setSeed(uint64_t seed);
+    bool isDeterministic() const;
+    // getBestMove()'s minimax search reports to `callback` after every root
+    // move: the best move so far with its line, and every root move searched
+    // (outside the best, upper bounds). An empty callback turns it off.
+    void setProgressCallback(const AnalysisCallback& callback);
+    // Minimax searches log (RECORD) or check (VERIFY) every node in `trace`;
+    // nullptr turns tracing off.
+    void setTrace(SearchTrace* trace);
+    void setSelectiveSearch(const SelectiveSearch& config);
+    const SelectiveSearch& getSelectiveSearch() const;
+    // Extra plies the search may spend past its depth resolving fives and
+    // fours (see quiescence()); 0 evaluates the horizon as it stands.
+    void setQuiescenceDepth(int plies);
+    int getQuiescenceDepth() const;
+    // Drops the MCTS tree kept for the next search and gives back the
+    // table's memory. For a new or loaded game; minimax searches start from
+    // an empty table and history anyway.
+    void newGame();
+    // Size of the minimax transposition table; clears it.
+    void setTableMegabytes(size_t megabytes);
+    // Thread-safe: makes a running getBestMove() return as soon as possible
+    // with the best move found so far. Stays in effect until clearStopRequest().
+    void requestStop();
+    void clearStopRequest();
+    bool isStopRequested() const;
+    const SearchStats& getLastSearchStats() const;
+    const MCTSStats& getLastMCTSStats() const;
+    const ArenaStats& getArenaStats() const;
+    PoolStats getPoolStats() const;
+    // Replaces the leaf evaluation; nullptr restores the built-in pattern evaluator.
+    void setEvaluator(std::unique_ptr<Evaluator> evaluator);
+    bool loadEvaluatorWeights(const std::string& path);
 
 private:
-    std::pair<int, int> getBestMoveWithDepth(const GameBoard& board, Player player, int depth);
-    int minimax(const GameBoard& board, int depth, int alpha, int beta, bool maximizing, Player player);
+    std::pair<int, int> getBestMoveMCTS(const GameBoard& board, Player player);
+    ScoredMove getBestMoveWithDepth(const GameBoard& board, Player player, int depth);
+    int minimax(GameBoard& board, int depth, int ply, int alpha, int beta, Player player);
+    int quiescence(GameBoard& board, int depth, int ply, int alpha, int beta, Player player);
     int evaluateBoard(const GameBoard& board, Player player);
-    int evaluatePattern(const GameBoard& board, int row, int col, int dRow, int dCol, Player player);
-    int evaluateMove(const GameBoard& board, int row, int col, Player player);
-    std::vector<std::pair<int, int>> getPossibleMoves(const GameBoard& board);
+    int evaluatePattern(const GameBoard& board, int row, int col, int dRow, int dCol, Player player,
+                        int* pattern = nullptr);
+    // Ordering score of a move; `forcing` is set if it makes or stops a six, five or open four.
+    int evaluateMove(const GameBoard& board, int row, int col, Player player, bool* forcing = nullptr);
+    int getPossibleMoves(const GameBoard& board, ScoredMove* moves);
+    // `tableMove` (a cell index, or -1) sorts first. `historyBonus` adds the
+    // history table to the scores; the root leaves it out. Ties still break
+    // on the history, but it and the table start empty at every search (see
+    // startSearch()), so the move played does not depend on earlier searches.
+    int orderMoves(const GameBoard& board, Player player, ScoredMove* moves, int tableMove = -1,
+                   bool historyBonus = false);
+    // Empties the history and the table for a new search.
+    void startSearch();
+    uint64_t tableKey(const GameBoard& board, Player player) const;
+    bool makeSearchMove(GameBoard& board, int row, int col, Player player);
+    void undoSearchMove(GameBoard& board, int row, int col, Player player);
     Player getOpponent(Player player);
     std::pair<int, int> getRandomMove(const GameBoard& board);
+    bool trySolve(const GameBoard& board, Player player, std::pair<int, int>& move, bool& won);
+    void recordPV(int ply, const std::pair<int, int>& move);
+    void publishSearchMetrics();
+
+    static const int MAX_PV = 32;
+    static const int DEFAULT_QUIESCENCE_DEPTH = 6;
+    // Added to forcing moves' ordering scores while selective search is on,
+    // so they sort first and every later move is quiet.
+    static const int FORCING_BONUS = 1 << 28;
+    static const int TABLE_MOVE_SCORE = 1 << 29;
+    // Below the root a move's ordering score gains HISTORY_WEIGHT per history
+    // point, up to HISTORY_CAP points; far below FORCING_BONUS either way.
+    static const int HISTORY_WEIGHT = 10;
+    static const uint32_t HISTORY_CAP = 100000;
 
     std::mt19937 rng;
     AIDifficulty currentDifficulty;
+    AIEngine currentEngine;
+    bool verbose;
+    bool deterministic;
+    SearchTrace* trace;
+    AnalysisCallback progress;
+    uint64_t mctsPlayoutLimit;      // 0: the difficulty's
+    int mctsTimeLimitMs;            // 0: the difficulty's
+    SearchStats searchStats;
+    SelectiveSearch selective;
+    bool selectiveActive;           // selective search applies to the current search
+    int quiescenceDepth;
+    std::atomic<bool> stopRequested;
+    ProofSolver solver;
+    MCTSEngine mcts;
+    SearchArena arena;
+    GameBoard workBoard;
+    PatternEvaluator patterns;
+    ThreatGenerator threats;
+    // Results of the current search only; see startSearch().
+    TranspositionTable table;
+    // Beta cutoffs by colour and cell, weighted by depth squared. Orders the
+    // moves below the root; cleared at every search.
+    uint32_t history[2][GameBoard::BOARD_SIZE * GameBoard::BOARD_SIZE];
+    std::unique_ptr<Evaluator> customEvaluator;
+    Evaluator* evaluator;
+    // Triangular principal-variation table: row `ply` holds the best line found from that ply.
+    std::pair<int, int> pvMoves[MAX_PV][MAX_PV];
+    int pvLength[MAX_PV];
 };
 
 #endif // GAMEAI_H 
\ No newline at end of file
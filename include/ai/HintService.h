@@ -0,0 +1,59 @@
+#ifndef HINTSERVICE_H
+#define HINTSERVICE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ai/AnalysisChannel.h"
+#include "ai/GameAI.h"
+#include "core/GameBoard.h"
+
+struct Hint {
+    std::vector<ScoredMove> moves;  // best first
+    int depth = 0;                  // last finished depth; 0 while the first is still running
+    bool final = false;             // analysis has finished
+};
+
+// Keeps an analysis of the current position running on a background thread
+// and caches its top moves, so a hint can be shown at once. Until the first
+// depth completes the cache holds the best moves searched so far.
+class HintService {
+public:
+    static const int DEFAULT_TOP_MOVES = 5;
+    static const int DEFAULT_MAX_DEPTH = 5;
+
+    explicit HintService(int topMoves = DEFAULT_TOP_MOVES, int maxDepth = DEFAULT_MAX_DEPTH);
+    ~HintService();
+
+    // Starts analysing `board` for the side to move, unless it already is.
+    void analyze(const GameBoard& board);
+    void stop();
+    // Also streams every analysis update to `channel` (nullptr to stop).
+    // Call while no analysis is running.
+    void setChannel(AnalysisChannel* channel);
+    // Copies the cached analysis of `board`, waiting up to `wait` for the
+    // first result; false if there is none.
+    bool getHint(const GameBoard& board, Hint& hint,
+                 std::chrono::milliseconds wait = std::chrono::milliseconds(0)) const;
+
+private:
+    void run();
+    void update(const AnalysisInfo& info);
+
+    GameAI ai;
+    GameBoard position;
+    std::thread worker;
+    int topMoves;
+    int maxDepth;
+    AnalysisChannel* channel;
+    uint64_t positionHash;
+    bool analyzing;
+    mutable std::mutex mutex;
+    mutable std::condition_variable updated;
+    Hint cached;
+};
+
+#endif // HINTSERVICE_H
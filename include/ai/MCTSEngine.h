@@ -0,0 +1,73 @@
+#ifndef MCTSENGINE_H
+#define MCTSENGINE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include "ai/SearchArena.h"
+#include "core/BitBoard.h"
+#include "core/GameBoard.h"
+#include "core/Player.h"
+
+struct MCTSStats {
+    uint64_t playouts = 0;
+    uint64_t nodes = 0;
+    uint64_t reusedVisits = 0;
+    int64_t elapsedMs = 0;
+    double playoutsPerSecond = 0.0;
+};
+
+// Monte Carlo Tree Search (UCT) over bitboard positions. Worker threads share
+// one tree and spread out with virtual loss; nodes come from a NodePool, and
+// the subtree of the position actually reached is kept for the next search
+// when possible.
+class MCTSEngine {
+public:
+    static const size_t DEFAULT_NODE_CAPACITY = 1 << 20;
+
+    explicit MCTSEngine(size_t nodeCapacity = DEFAULT_NODE_CAPACITY);
+    ~MCTSEngine();
+
+    std::pair<int, int> search(const GameBoard& board, Player player, uint64_t maxPlayouts, int maxTimeMs);
+    void setThreadCount(int threads);
+    void setSeed(uint64_t seed);
+    // search() returns its best move so far as soon as *flag becomes true.
+    void setStopFlag(const std::atomic<bool>* flag);
+    void reset();
+    const MCTSStats& getLastStats() const;
+    PoolStats getPoolStats() const;
+
+private:
+    struct Node;
+
+    struct Position {
+        BitBoard stones[2];
+        BitBoard empty;
+        BitBoard candidates;
+        int toMove = 0;
+        int winner = -1;
+
+        void play(int index);
+    };
+
+    void worker(int threadId, uint64_t maxPlayouts, std::chrono::steady_clock::time_point deadline);
+    int runPlayout(Position position, uint64_t& rng) const;
+    bool expand(Node& node, const Position& position);
+    Node* selectChild(Node& node);
+    bool reuseTree(const Position& position);
+    static Position toPosition(const GameBoard& board, Player player);
+
+    std::unique_ptr<NodePool<Node>> nodes;
+    std::atomic<uint64_t> playouts;
+    int32_t root;
+    Position rootPosition;
+    int threadCount;
+    const std::atomic<bool>* stopFlag;
+    uint64_t seed;
+    MCTSStats lastStats;
+};
+
+#endif // MCTSENGINE_H
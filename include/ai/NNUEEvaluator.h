@@ -0,0 +1,63 @@
+#ifndef NNUEEVALUATOR_H
+#define NNUEEVALUATOR_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "ai/BoardWindows.h"
+#include "ai/Evaluator.h"
+
+// Quantized network parameters. Inputs are the states of every six-cell
+// window on the board (empty, 1-6 own stones, 1-6 opposing stones, or dead),
+// bucketed by distance from the center; a window in a given state adds one
+// row of feature weights to the hidden layer.
+struct NNUEWeights {
+    static const int WINDOW_STATES = 14;
+    static const int BUCKETS = 3;
+    static const int FEATURES = WINDOW_STATES * BUCKETS;
+    static const int HIDDEN = 32;
+    static const int ACTIVATION_MAX = 127;
+
+    alignas(64) int16_t features[FEATURES][HIDDEN];
+    alignas(64) int16_t hiddenBias[HIDDEN];
+    // The first HIDDEN weights apply to the side to move, the rest to its opponent.
+    alignas(64) int16_t output[2 * HIDDEN];
+    int32_t outputBias = 0;
+    int outputShift = 0;
+
+    // Text format: "connect6-nnue 1", the hidden size, then features, hidden
+    // biases, output weights, output bias and output shift as integers.
+    static std::shared_ptr<const NNUEWeights> load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    // Weights loaded once from CONNECT6_NNUE or the default path; nullptr if
+    // neither names a readable file.
+    static std::shared_ptr<const NNUEWeights> shared();
+    static void setDefaultPath(const std::string& path);
+};
+
+// NNUE-style evaluator: the hidden layer is kept as two int16 accumulators
+// (one per perspective) that make/undo update by the handful of windows
+// through the changed cell, so a leaf costs one clipped-ReLU dot product.
+class NNUEEvaluator : public Evaluator {
+public:
+    static const int WINDOW_COUNT = BoardWindows::COUNT;
+
+    explicit NNUEEvaluator(std::shared_ptr<const NNUEWeights> weights);
+
+    void reset(const GameBoard& board) override;
+    void onMakeMove(int row, int col, Player player) override;
+    void onUndoMove(int row, int col, Player player) override;
+    int evaluate(const GameBoard& board, Player player) override;
+
+private:
+    void updateCell(int cell, int color, int delta);
+    int feature(int window, int perspective) const;
+
+    std::shared_ptr<const NNUEWeights> weights;
+    alignas(64) int16_t accumulators[2][NNUEWeights::HIDDEN];
+    WindowStones counts;
+    int stones;
+};
+
+#endif // NNUEEVALUATOR_H
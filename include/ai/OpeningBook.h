@@ -0,0 +1,38 @@
+#ifndef OPENINGBOOK_H
+#define OPENINGBOOK_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "core/GameBoard.h"
+
+// Book replies keyed by canonical position hash, so one entry covers all
+// eight symmetric versions of a position. Immutable once built, so a single
+// instance can be probed by any number of threads.
+class OpeningBook {
+public:
+    // Text format: "connect6-book 1" followed by one opening per line as
+    // moves in MoveNotation ("h8 i9 g9"); every prefix gets the next move as
+    // its reply unless an earlier line already gave one.
+    static std::shared_ptr<const OpeningBook> load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    // Book loaded once from CONNECT6_BOOK or the default path; nullptr if
+    // neither names a readable file.
+    static std::shared_ptr<const OpeningBook> shared();
+    static void setDefaultPath(const std::string& path);
+
+    // False if a move of the line is illegal; the legal prefix is kept.
+    bool addLine(const std::vector<std::pair<int, int>>& moves);
+    bool probe(const GameBoard& board, std::pair<int, int>& move) const;
+    size_t size() const;
+
+private:
+    std::unordered_map<uint64_t, uint8_t> replies;     // canonical hash -> canonical cell
+    std::vector<std::vector<std::pair<int, int>>> lines;  // as added, for save()
+};
+
+#endif // OPENINGBOOK_H
@@ -0,0 +1,68 @@
+#ifndef PATTERNEVALUATOR_H
+#define PATTERNEVALUATOR_H
+
+#include <memory>
+#include <string>
+#include "ai/Evaluator.h"
+
+// Scores used by PatternEvaluator. The defaults are the original hand-picked
+// values; tools/tune_eval fits new ones from self-play games.
+struct PatternWeights {
+    enum Pattern {
+        SIX,
+        FIVE,
+        OPEN_FOUR,
+        FOUR,
+        OPEN_THREE,
+        THREE,
+        OPEN_TWO,
+        TWO,
+        PATTERN_COUNT
+    };
+
+    int patterns[PATTERN_COUNT] = {100000, 50000, 10000, 5000, 1000, 500, 100, 50};
+    int center = 10;    // per step closer to the center, within two steps of it
+    int defense = 200;  // opponent patterns count this many percent of their score
+
+    // Text format: "connect6-patterns 1" followed by "name value" lines.
+    static std::shared_ptr<const PatternWeights> load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    // Weights loaded once from CONNECT6_WEIGHTS or the default path; nullptr
+    // if neither names a readable file.
+    static std::shared_ptr<const PatternWeights> shared();
+    static void setDefaultPath(const std::string& path);
+};
+
+// Pattern counts behind one evaluate() call (blocked patterns count half), so
+// that evaluate() == sum(weight * (own - defense% * opponent)) + center * center
+// up to integer rounding.
+struct PatternFeatures {
+    double own[PatternWeights::PATTERN_COUNT] = {};
+    double opponent[PatternWeights::PATTERN_COUNT] = {};
+    double center = 0.0;
+};
+
+// Hand-written evaluation: center control plus scored line patterns.
+class PatternEvaluator : public Evaluator {
+public:
+    explicit PatternEvaluator(const PatternWeights& weights = PatternWeights());
+
+    int evaluate(const GameBoard& board, Player player) override;
+    // Score of the line through (row, col) for `player`. `pattern`, if given,
+    // receives the line's PatternWeights::Pattern, or PATTERN_COUNT if it scores nothing.
+    int evaluatePattern(const GameBoard& board, int row, int col, int dRow, int dCol, Player player,
+                        int* pattern = nullptr) const;
+    void getFeatures(const GameBoard& board, Player player, PatternFeatures& features) const;
+
+    const PatternWeights& getWeights() const;
+    void setWeights(const PatternWeights& weights);
+
+private:
+    // Pattern through (row, col) in one direction, or -1 if it scores nothing.
+    int classifyPattern(const GameBoard& board, int row, int col, int dRow, int dCol, Player player, bool& blocked) const;
+
+    PatternWeights weights;
+};
+
+#endif // PATTERNEVALUATOR_H
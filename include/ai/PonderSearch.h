@@ -0,0 +1,63 @@
+#ifndef PONDERSEARCH_H
+#define PONDERSEARCH_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "ai/GameAI.h"
+#include "core/GameBoard.h"
+#include "core/Player.h"
+
+struct PonderStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+// Thinks on the opponent's time. After the AI has moved, start() predicts the
+// human's reply with a quick search and then runs the AI's full search on the
+// position after that reply, on a background thread and with the AI's own
+// engine, so its search state stays warm. finish() is given the move actually
+// played: on a hit the answer is ready or arrives when the running search
+// ends, on a miss the ponder search is stopped and the caller searches as
+// usual.
+//
+// While pondering the background thread owns `ai`; call cancel(), or wait
+// for the answer of a hit, before using it from any other thread.
+class PonderSearch {
+public:
+    // Called on the ponder thread with the AI's answer.
+    using ReplyCallback = std::function<void(std::pair<int, int>)>;
+
+    explicit PonderSearch(GameAI& ai);
+    ~PonderSearch();
+
+    void start(const GameBoard& board, Player human);
+    // False on a miss. On a hit whose search has ended the answer is in
+    // `reply`; while it still runs `reply` is (-1, -1) and `pending` gets
+    // the answer when it ends. Never waits for a running search.
+    bool finish(const std::pair<int, int>& played, std::pair<int, int>& reply, const ReplyCallback& pending);
+    void cancel();
+    bool isActive() const;
+    const PonderStats& getStats() const;
+
+private:
+    void run();
+    void stop();
+
+    GameAI& ai;
+    GameAI predictor;
+    GameBoard position;
+    Player human;
+    std::thread worker;
+    std::atomic<int> predicted;     // row * BOARD_SIZE + col of the predicted reply, -1 until known
+    std::mutex mutex;               // guards reply, searched and onReply
+    std::pair<int, int> reply;
+    bool searched;                  // the AI's search has ended
+    ReplyCallback onReply;          // set by a hit that found the search running
+    PonderStats stats;
+};
+
+#endif // PONDERSEARCH_H
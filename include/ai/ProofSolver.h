@@ -0,0 +1,97 @@
+#ifndef PROOFSOLVER_H
+#define PROOFSOLVER_H
+
+#include <atomic>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include "ai/BoardWindows.h"
+#include "ai/SearchArena.h"
+#include "core/GameBoard.h"
+#include "core/Player.h"
+
+enum class ProofResult {
+    WIN,
+    LOSS,
+    DRAW,
+    UNKNOWN
+};
+
+struct SolverResult {
+    ProofResult result = ProofResult::UNKNOWN;
+    std::pair<int, int> bestMove = {-1, -1};
+    uint64_t nodes = 0;
+    uint64_t tableProbes = 0;
+    uint64_t tableHits = 0;
+};
+
+// Depth-first proof-number (df-pn) solver. Proves the game-theoretic value of a
+// position for the side to move within a node budget, using a fixed-size
+// transposition table keyed by the canonical board hash.
+class ProofSolver {
+public:
+    static const uint64_t DEFAULT_NODE_BUDGET = 200000;
+    static const size_t DEFAULT_TABLE_ENTRIES = 1 << 18;
+    static const int ENDGAME_EMPTY_CELLS = 20;
+    static const int ENDGAME_LIVE_CELLS = 24;
+
+    explicit ProofSolver(size_t tableEntries = DEFAULT_TABLE_ENTRIES,
+                         uint64_t nodeBudget = DEFAULT_NODE_BUDGET);
+
+    SolverResult solve(const GameBoard& board, Player player);
+    void setNodeBudget(uint64_t budget);
+    uint64_t getNodeBudget() const;
+    // The table is allocated by the first solve(), so an engine that never
+    // reaches an endgame never pays for it.
+    void setTableEntries(size_t entries);
+    // Fraction of table slots in use; the table is kept between solves.
+    double getTableFill() const;
+    // solve() gives up with UNKNOWN as soon as *flag becomes true.
+    void setStopFlag(const std::atomic<bool>* flag);
+    const ArenaStats& getArenaStats() const;
+
+    // True when the position is small enough that solve() is expected to finish in budget.
+    static bool isEndgame(const GameBoard& board);
+    // Cells that still lie on a six-window free of the other colour, for either side.
+    static std::vector<std::pair<int, int>> getLiveCells(const GameBoard& board);
+
+private:
+    struct Entry {
+        uint64_t key;
+        uint32_t phi;
+        uint32_t delta;
+        uint32_t work;
+    };
+
+    void mid(GameBoard& board, uint32_t thPhi, uint32_t thDelta, uint32_t& phi, uint32_t& delta);
+    bool terminalValues(const GameBoard& board, uint32_t& phi, uint32_t& delta) const;
+    uint64_t tableKey(const GameBoard& board) const;
+    bool lookup(const GameBoard& board, uint32_t& phi, uint32_t& delta) const;
+    void store(const GameBoard& board, uint32_t phi, uint32_t delta, uint32_t work);
+    void resetWindows(const GameBoard& board);
+    void play(GameBoard& board, const std::pair<int, int>& move, Player player);
+    void unplay(GameBoard& board, const std::pair<int, int>& move, Player player);
+    int getSolverMoves(const GameBoard& board, ScoredMove* moves) const;
+    ProofResult prove(GameBoard& board, Player attacker, std::pair<int, int>& move);
+    Player getOpponent(Player player) const;
+
+    std::vector<Entry> table;
+    size_t tableSize;
+    size_t tableUsed;
+    mutable uint64_t tableProbes;
+    mutable uint64_t tableHits;
+    SearchArena arena;
+    uint64_t nodeBudget;
+    const std::atomic<bool>* stopFlag;
+    uint64_t nodes;
+    bool aborted;
+    Player attacker;
+    int rootMoveCount;
+    std::pair<int, int> rootMove;
+    // Stones of each colour inside every six-cell window, kept in step with the board.
+    WindowStones stonesInWindow;
+    int attackerLiveWindows;
+};
+
+#endif // PROOFSOLVER_H
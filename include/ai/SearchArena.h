@@ -0,0 +1,131 @@
+#ifndef SEARCHARENA_H
+#define SEARCHARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "core/GameBoard.h"
+
+struct ScoredMove {
+    std::pair<int, int> move;
+    int score;
+};
+
+struct ArenaStats {
+    size_t moveListBytes = 0;
+    size_t scratchCapacity = 0;
+    size_t scratchPeak = 0;
+    uint64_t scratchAllocations = 0;
+    uint64_t heapAllocations = 0;   // blocks obtained from the heap since construction
+    uint64_t resets = 0;
+};
+
+// Per-search memory for the tree searches. Every ply owns a fixed move-list
+// slot, and scratch buffers come from a bump stack released with mark/release.
+// Memory is obtained once and kept, so reset() is O(1) and a warmed-up search
+// performs no heap allocation.
+class SearchArena {
+public:
+    static const int MAX_PLY = GameBoard::BOARD_SIZE * GameBoard::BOARD_SIZE + 1;
+    static const int MAX_MOVES = GameBoard::BOARD_SIZE * GameBoard::BOARD_SIZE;
+    static const size_t DEFAULT_SCRATCH_BYTES = 1 << 20;
+
+    explicit SearchArena(size_t scratchBytes = DEFAULT_SCRATCH_BYTES);
+
+    ScoredMove* moves(int ply);
+
+    template <typename T>
+    T* allocate(size_t count) {
+        return static_cast<T*>(allocateBytes(count * sizeof(T), alignof(T)));
+    }
+
+    struct Mark {
+        size_t block;
+        size_t offset;
+    };
+    Mark mark() const;
+    void release(const Mark& mark);
+    void reset();
+
+    const ArenaStats& getStats() const;
+
+private:
+    void* allocateBytes(size_t bytes, size_t alignment);
+
+    std::unique_ptr<ScoredMove[]> moveLists;
+    std::vector<std::unique_ptr<unsigned char[]>> blocks;
+    std::vector<size_t> blockSizes;
+    size_t blockSize;
+    size_t currentBlock;
+    size_t offset;
+    size_t used;
+    ArenaStats stats;
+};
+
+struct PoolStats {
+    size_t capacity = 0;
+    size_t used = 0;
+    size_t peak = 0;
+    uint64_t failedAllocations = 0;
+    uint64_t resets = 0;
+};
+
+// Fixed-capacity node storage for tree-based engines. Contiguous runs of nodes
+// are handed out with an atomic bump index, so any number of threads may
+// allocate concurrently; reset() forgets every node in O(1).
+template <typename T>
+class NodePool {
+public:
+    explicit NodePool(size_t capacity) : poolCapacity(capacity), count(0), peak(0), failed(0), resets(0) {}
+
+    // Index of the first of `n` consecutive nodes, or -1 when the pool is full.
+    int64_t allocate(size_t n) {
+        if (!storage) storage.reset(new T[poolCapacity]);
+        size_t first = count.load(std::memory_order_relaxed);
+        do {
+            if (first + n > poolCapacity) {
+                failed.fetch_add(1, std::memory_order_relaxed);
+                return -1;
+            }
+        } while (!count.compare_exchange_weak(first, first + n, std::memory_order_relaxed));
+
+        size_t high = peak.load(std::memory_order_relaxed);
+        while (first + n > high && !peak.compare_exchange_weak(high, first + n, std::memory_order_relaxed)) {
+        }
+        return static_cast<int64_t>(first);
+    }
+
+    void reset() {
+        count.store(0, std::memory_order_relaxed);
+        resets++;
+    }
+
+    T& operator[](size_t index) { return storage[index]; }
+    const T& operator[](size_t index) const { return storage[index]; }
+    size_t indexOf(const T* node) const { return static_cast<size_t>(node - storage.get()); }
+    size_t size() const { return count.load(std::memory_order_relaxed); }
+    size_t capacity() const { return poolCapacity; }
+
+    PoolStats getStats() const {
+        PoolStats stats;
+        stats.capacity = poolCapacity;
+        stats.used = size();
+        stats.peak = peak.load(std::memory_order_relaxed);
+        stats.failedAllocations = failed.load(std::memory_order_relaxed);
+        stats.resets = resets;
+        return stats;
+    }
+
+private:
+    std::unique_ptr<T[]> storage;
+    size_t poolCapacity;
+    std::atomic<size_t> count;
+    std::atomic<size_t> peak;
+    std::atomic<uint64_t> failed;
+    uint64_t resets;
+};
+
+#endif // SEARCHARENA_H
@@ -0,0 +1,67 @@
+#ifndef SEARCHTRACE_H
+#define SEARCHTRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "core/Player.h"
+
+// First event where a verified search left the recorded one.
+struct TraceDivergence {
+    uint64_t node = 0;                          // ENTER events before it
+    std::vector<std::pair<int, int>> path;      // moves from the search root
+    std::string expected;
+    std::string actual;
+};
+
+// Compact binary log of minimax searches: every node entered (by the move
+// leading to it), how it ended (leaf, terminal, interior, beta cutoff, table
+// hit) and its score. In RECORD mode GameAI's hooks append events; in VERIFY
+// mode they are checked against a loaded trace, so a second build can be
+// compared node for node and the first difference reported with its path.
+//
+// Events are one tag byte, then a cell byte for moves and a zigzag varint for
+// scores, so a node costs about five bytes.
+class SearchTrace {
+public:
+    enum class Mode { RECORD, VERIFY };
+    enum class NodeKind : uint8_t { LEAF, TERMINAL, INTERIOR, CUTOFF, STOPPED, TABLE };
+
+    SearchTrace();
+
+    bool save(const std::string& path) const;
+    // Loads a recorded trace and switches to VERIFY mode.
+    bool load(const std::string& path);
+    void clear();
+
+    Mode getMode() const;
+    uint64_t getNodes() const;
+    size_t getBytes() const;
+    bool hasDivergence() const;
+    const TraceDivergence& getDivergence() const;
+    // VERIFY mode: true once every recorded event has been matched.
+    bool isComplete() const;
+
+    // Hooks called by the search.
+    void beginSearch(uint64_t hash, Player player, int depth);
+    void enter(const std::pair<int, int>& move);
+    void exit(NodeKind kind, int score);
+    void endSearch(const std::pair<int, int>& move, int score);
+
+private:
+    void put(const uint8_t* event, size_t size);
+    std::string describe(const uint8_t* event, size_t size) const;
+    size_t eventSize(size_t offset) const;
+
+    Mode mode;
+    std::vector<uint8_t> data;
+    size_t position;                            // VERIFY: next recorded byte
+    uint64_t nodes;
+    std::vector<std::pair<int, int>> path;
+    bool diverged;
+    TraceDivergence divergence;
+};
+
+#endif // SEARCHTRACE_H
@@ -0,0 +1,44 @@
+#ifndef THREATGENERATOR_H
+#define THREATGENERATOR_H
+
+#include <cstdint>
+#include <vector>
+#include "ai/BoardWindows.h"
+#include "ai/SearchArena.h"
+#include "core/GameBoard.h"
+#include "core/Player.h"
+
+// Threat moves for searching past the horizon. A six-cell window holding five
+// stones of one colour and nothing else is a five: its empty cell wins on the
+// next move. A window holding four and two empty cells is a four, one move
+// away from a five.
+//
+// Like an Evaluator, the generator is reset on the root position and told of
+// every move the search makes and takes back. It keeps the stone counts of
+// every window, so a position without fives or fours costs nothing to check.
+class ThreatGenerator {
+public:
+    ThreatGenerator();
+
+    void reset(const GameBoard& board);
+    void onMakeMove(int row, int col, Player player);
+    void onUndoMove(int row, int col, Player player);
+
+    bool hasFive(Player player) const;
+    bool hasFour(Player player) const;
+    // Empty cells that complete a six for `player`, each listed once.
+    int getWinningCells(Player player, ScoredMove* cells) const;
+    // Empty cells that make a five for `player`, scored by the number of fives
+    // made and sorted best first.
+    int getThreatMoves(Player player, ScoredMove* moves) const;
+
+private:
+    void update(int row, int col, Player player, int delta);
+
+    std::vector<Player> cells;
+    WindowStones stones;
+    // Windows holding `k` stones of a colour and none of the other, by colour and k.
+    int openWindows[2][GameBoard::WIN_LENGTH + 1];
+};
+
+#endif // THREATGENERATOR_H
@@ -0,0 +1,93 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Minimax results by position for one search. newSearch() starts the next
+// one: entries of earlier searches then read as misses and are replaced
+// first, and every AGE_CYCLE searches the memory is wiped so none of them
+// comes back. clear() wipes it at once; GameAI calls it for a new
+// evaluator, search setting or difficulty and in newGame(), and
+// setEntries() does it too.
+//
+// Entries are 16 bytes, four to a 64-byte bucket, so a probe reads one cache
+// line. A result goes to its position's slot in the bucket if there is one,
+// otherwise over an entry of an earlier search, or else over the
+// shallowest.
+//
+// probe(), store() and prefetch() take no lock and may run on many threads
+// sharing one table. Each entry is two words, the second the key XOR the
+// first, so an entry torn by two threads storing at once no longer matches
+// its key and reads as a miss. The other calls must not run alongside them.
+class TranspositionTable {
+public:
+    static const size_t DEFAULT_ENTRIES = size_t(1) << 18;     // 4 MB
+    static const size_t ENTRIES_PER_BUCKET = 4;
+    static const size_t ENTRY_BYTES = 16;
+
+    enum Bound : uint8_t { NONE, EXACT, LOWER, UPPER };
+
+    struct Entry {
+        uint64_t key;
+        int32_t score;
+        int16_t move;           // row * BOARD_SIZE + col, or -1
+        int8_t depth;
+        Bound bound;
+        uint8_t age;            // search that stored it, modulo AGE_CYCLE
+    };
+
+    explicit TranspositionTable(size_t entries = DEFAULT_ENTRIES);
+    ~TranspositionTable();
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // Memory is mapped zeroed by the constructor and setEntries(), so the
+    // table is ready before threads share it. The system only backs the
+    // pages a search touches: an engine that never searches with minimax
+    // costs address space, not memory. Tables of 2 MB and more are aligned
+    // for transparent huge pages where the system has them.
+    bool probe(uint64_t key, Entry& entry) const;
+    void store(uint64_t key, int score, int depth, Bound bound, int move);
+    // Starts loading the bucket of `key` into the cache, for a probe soon after.
+    void prefetch(uint64_t key) const;
+    // Starts a new search: entries from earlier searches become misses.
+    void newSearch();
+    void clear();
+    // Rounded down to a power of two buckets; clears the table.
+    void setEntries(size_t entries);
+    void setMegabytes(size_t megabytes);
+
+    size_t getEntries() const;
+    size_t getBytes() const;
+    // Fraction of slots holding an entry, sampled from the first buckets.
+    double getFill() const;
+
+private:
+    static const int AGE_CYCLE = 64;
+    static const size_t FILL_SAMPLE_BUCKETS = 1024;
+
+    struct Slot {
+        std::atomic<uint64_t> check;    // key ^ data
+        std::atomic<uint64_t> data;     // score, move, depth, bound and age
+    };
+
+    struct alignas(64) Bucket {
+        Slot entries[ENTRIES_PER_BUCKET];
+    };
+    static_assert(sizeof(Slot) == ENTRY_BYTES && sizeof(Bucket) == 64, "a bucket is one cache line");
+
+    static uint64_t pack(int score, int move, int depth, Bound bound, uint8_t entryAge);
+    static void unpack(uint64_t key, uint64_t data, Entry& entry);
+    bool allocate();
+    void release();
+
+    Bucket* buckets;
+    size_t bucketCount;
+    void* memory;           // start of the mapping `buckets` lies in
+    size_t mappedBytes;
+    uint8_t age;
+};
+
+#endif // TRANSPOSITIONTABLE_H
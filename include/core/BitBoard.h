@@ -0,0 +1,86 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#include "core/GameBoard.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+inline int popCount64(uint64_t bits) { return static_cast<int>(__popcnt64(bits)); }
+inline int lowestBit64(uint64_t bits) { unsigned long index; _BitScanForward64(&index, bits); return static_cast<int>(index); }
+#else
+inline int popCount64(uint64_t bits) { return __builtin_popcountll(bits); }
+inline int lowestBit64(uint64_t bits) { return __builtin_ctzll(bits); }
+#endif
+
+// 15x15 board packed into four 64-bit words with a 16-cell row stride. The
+// unused 16th column stays zero, so line scans never wrap between rows.
+class BitBoard {
+public:
+    static const int STRIDE = 16;
+    static const int WORDS = 4;
+    static const int CELLS = GameBoard::BOARD_SIZE * STRIDE;
+
+    BitBoard() : words{0, 0, 0, 0} {}
+
+    static int index(int row, int col) { return row * STRIDE + col; }
+    static int row(int index) { return index / STRIDE; }
+    static int col(int index) { return index % STRIDE; }
+
+    bool test(int index) const { return (words[index >> 6] >> (index & 63)) & 1; }
+    void set(int index) { words[index >> 6] |= uint64_t(1) << (index & 63); }
+    void clear(int index) { words[index >> 6] &= ~(uint64_t(1) << (index & 63)); }
+
+    bool isEmpty() const { return (words[0] | words[1] | words[2] | words[3]) == 0; }
+    int count() const {
+        return popCount64(words[0]) + popCount64(words[1]) +
+               popCount64(words[2]) + popCount64(words[3]);
+    }
+
+    // Index of the n-th set bit (0-based), or -1 if there are not that many.
+    int nthSetBit(int n) const {
+        for (int w = 0; w < WORDS; ++w) {
+            uint64_t bits = words[w];
+            int c = popCount64(bits);
+            if (n >= c) {
+                n -= c;
+                continue;
+            }
+            for (; n > 0; --n) bits &= bits - 1;
+            return w * 64 + lowestBit64(bits);
+        }
+        return -1;
+    }
+
+    BitBoard& operator|=(const BitBoard& other) {
+        for (int w = 0; w < WORDS; ++w) words[w] |= other.words[w];
+        return *this;
+    }
+    BitBoard& operator&=(const BitBoard& other) {
+        for (int w = 0; w < WORDS; ++w) words[w] &= other.words[w];
+        return *this;
+    }
+    BitBoard andNot(const BitBoard& other) const {
+        BitBoard result;
+        for (int w = 0; w < WORDS; ++w) result.words[w] = words[w] & ~other.words[w];
+        return result;
+    }
+    bool operator==(const BitBoard& other) const {
+        return words[0] == other.words[0] && words[1] == other.words[1] &&
+               words[2] == other.words[2] && words[3] == other.words[3];
+    }
+
+    // Cells within two steps (king distance) of `index`.
+    static const BitBoard& neighborhood(int index);
+    // Every playable cell.
+    static const BitBoard& full();
+    // True if `stones` plus a stone at `index` contains WIN_LENGTH in a row through it.
+    static bool makesLine(const BitBoard& stones, int index);
+
+    static BitBoard fromGameBoard(const GameBoard& board, Player player);
+
+private:
+    uint64_t words[WORDS];
+};
+
+#endif // BITBOARD_H
@@ -0,0 +1,96 @@
+#ifndef GAMEARCHIVE_H
+#define GAMEARCHIVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "core/GameBoard.h"
+
+// Binary archive of many games, several times smaller than their
+// saveGame() text and read back without parsing.
+//
+// Games are the cells played from the empty board; colours alternate from
+// black, as GameBoard::makeMove() requires, so they are not stored. Each move
+// is the zigzag varint of its cell minus the previous move's cell, which is
+// one byte for the nearby replies most moves are. Games are grouped into
+// blocks of about 64 KB, each block starting with its games' byte sizes so
+// one game can be found without decoding the ones before it. Every block is
+// compressed on its own with a small LZ77 coder, which removes repeated
+// openings and lines. An index of blocks at the end of the file gives random
+// access by game number.
+class GameArchiveWriter {
+public:
+    static const size_t DEFAULT_BLOCK_BYTES = 64 * 1024;
+
+    // `threads` compress blocks in parallel in write(); 0 uses every core.
+    explicit GameArchiveWriter(int threads = 0);
+
+    void setBlockBytes(size_t bytes);
+    // False if a move is off the board; the game is not added then.
+    bool add(const std::vector<std::pair<int, int>>& moves);
+    void add(const GameBoard& game);
+    size_t size() const;
+
+    // Compresses every block and writes the archive; the games stay added.
+    bool write(const std::string& path);
+    size_t getLastBytes() const;
+
+private:
+    struct Block {
+        std::vector<uint8_t> sizes;     // varint byte size of each game
+        std::vector<uint8_t> games;
+        uint32_t gameCount = 0;
+    };
+
+    int threadCount;
+    size_t blockBytes;
+    size_t gameCount;
+    std::vector<Block> blocks;
+    size_t lastBytes;
+};
+
+class GameArchiveReader {
+public:
+    GameArchiveReader();
+
+    // Reads the block index; games are read as they are asked for.
+    bool open(const std::string& path);
+    void close();
+    size_t size() const;
+    size_t getBlockCount() const;
+
+    // Moves of game `index`, or false if there is no such game or its block
+    // is damaged. Games from the last block read need no decompression.
+    bool read(size_t index, std::vector<std::pair<int, int>>& moves);
+    // Replays game `index` onto `game` after resetting it.
+    bool read(size_t index, GameBoard& game);
+    // Calls `visit` with every game in order, reading the file front to back.
+    bool scan(const std::function<void(size_t index, const std::vector<std::pair<int, int>>& moves)>& visit);
+
+private:
+    struct BlockInfo {
+        uint64_t offset;
+        uint32_t storedBytes;
+        uint32_t rawBytes;
+        uint64_t firstGame;
+        uint32_t gameCount;
+    };
+
+    bool loadBlock(size_t block);
+    bool decodeGame(size_t game, std::vector<std::pair<int, int>>& moves) const;
+
+    std::ifstream file;
+    std::vector<BlockInfo> blocks;
+    uint64_t gameCount;
+    // The block read last, decompressed, and where each of its games starts.
+    size_t cachedBlock;
+    std::vector<uint8_t> stored;
+    std::vector<uint8_t> raw;
+    std::vector<uint32_t> gameOffsets;
+};
+
+#endif // GAMEARCHIVE_H
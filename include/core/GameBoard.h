@@ -4,6 +4,8 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <array>
+#include <cstdint>
 #include <QObject>
 #include "core/Player.h"
 #include "core/GameState.h"
@@ -14,6 +16,7 @@ class GameBoard : public QObject {
 public:
     static const int BOARD_SIZE = 15;
     static const int WIN_LENGTH = 6;
+    static const int SYMMETRY_COUNT = 8;
 
     GameBoard();
     ~GameBoard() = default;
@@ -29,11 +32,24 @@ public:
     void undoLastMove();
     std::vector<std::pair<int, int>> getValidMoves() const;
     std::string getMoveHistory() const;
+    int getMoveCount() const;
+    // Cell of move `index` (0 = the first move); colours alternate from black.
+    std::pair<int, int> getMove(int index) const;
     void saveGame(const std::string& filename) const;
     bool loadGame(const std::string& filename);
     std::pair<int, int> getHint() const;
     void undoMove();
-    std::vector<std::pair<int, int>> getWinningLine() const;
+    const std::vector<std::pair<int, int>>& getWinningLine() const;
+
+    // Zobrist hash of the position as it stands on the board.
+    uint64_t getHash() const;
+    // Smallest hash over the 8 rotations/reflections; equal for all symmetric positions.
+    uint64_t getCanonicalHash() const;
+    // Symmetry that maps this board onto its canonical orientation.
+    int getCanonicalSymmetry() const;
+    static std::pair<int, int> transformMove(int row, int col, int symmetry);
+    static std::pair<int, int> inverseTransformMove(int row, int col, int symmetry);
+    static int inverseSymmetry(int symmetry);
 
 signals:
     void boardChanged();
@@ -41,12 +57,17 @@ signals:
     void moveMade(int row, int col, Player player);
 
 private:
+    // Restores snapshots straight into the members below.
+    friend class GameTimeline;
+
     std::vector<std::vector<Player>> board;
     std::vector<std::tuple<int, int, Player>> moveHistory;
     Player currentPlayer;
     GameState gameState;
     std::vector<std::pair<int, int>> winningLine;
+    std::array<uint64_t, SYMMETRY_COUNT> hashes;
 
+    void updateHashes(int row, int col, Player player);
     bool checkWin(int row, int col, Player player);
     bool checkDirection(int row, int col, int dRow, int dCol, Player player) const;
     bool checkLine(int row, int col, int dRow, int dCol, Player player);
@@ -0,0 +1,53 @@
+#ifndef GAMETIMELINE_H
+#define GAMETIMELINE_H
+
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include "core/BitBoard.h"
+#include "core/GameBoard.h"
+
+// The moves of one game as a seekable line of positions. A board on the line
+// moves to any other ply by restoring the nearest snapshot at or before it
+// and replaying at most SNAPSHOT_INTERVAL moves, or by stepping there
+// directly when that is shorter, so a seek costs the same early or late in
+// a full 225-move game.
+class GameTimeline {
+public:
+    static const int SNAPSHOT_INTERVAL = 16;
+
+    GameTimeline();
+
+    // Forgets every move.
+    void clear();
+    // Brings the line up to `game`: keeps it if `game` is one of its
+    // positions, otherwise drops the moves after the last one they share and
+    // appends the rest of `game`. Costs the moves that differ, not the game.
+    void sync(const GameBoard& game);
+
+    // Number of moves; plies run from 0 (empty board) to size().
+    int size() const;
+    // True if `board` is the position after the first getMoveCount() moves.
+    bool contains(const GameBoard& board) const;
+    // Puts `board` at `ply` and returns true, or false if `ply` is out of range.
+    bool seek(GameBoard& board, int ply) const;
+
+private:
+    // Stones and hashes after a multiple of SNAPSHOT_INTERVAL moves.
+    struct Snapshot {
+        BitBoard stones[2];
+        std::array<uint64_t, GameBoard::SYMMETRY_COUNT> hashes;
+    };
+
+    void truncate(int count);
+    void append(int row, int col, Player player);
+    void restore(GameBoard& board, int ply) const;
+
+    std::vector<std::tuple<int, int, Player>> moves;
+    std::vector<uint64_t> plyHashes;    // getHash() after each ply, size() + 1 of them
+    std::vector<Snapshot> snapshots;    // snapshots[i] is ply i * SNAPSHOT_INTERVAL
+    GameBoard end;                      // the position after every move, for appending
+};
+
+#endif // GAMETIMELINE_H
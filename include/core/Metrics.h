@@ -0,0 +1,121 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Process-wide health metrics (search latency, nodes, cache hit rates, UI
+// repaint times), dumped on demand as Prometheus text or JSON.
+//
+// Updating a metric is a relaxed atomic add with no locks. Registration takes
+// the registry lock, so hot code looks its metrics up once and keeps the
+// reference, which stays valid for the life of the process:
+//
+//   static MetricCounter& searches = MetricsRegistry::global().counter(
+//       "connect6_searches_total", "Searches run");
+//   searches.add();
+
+class MetricCounter {
+public:
+    void add(uint64_t amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value{0};
+};
+
+class MetricGauge {
+public:
+    void set(double amount) { value.store(amount, std::memory_order_relaxed); }
+    double get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> value{0.0};
+};
+
+// Counts observations into fixed buckets given by their upper bounds, plus an
+// implicit +Inf bucket. Percentiles are estimated from the buckets.
+class MetricHistogram {
+public:
+    explicit MetricHistogram(const std::vector<double>& bounds);
+
+    void observe(double value);
+    uint64_t getCount() const;
+    double getSum() const;
+    // Linear interpolation inside the bucket holding the q-th observation.
+    double quantile(double q) const;
+
+    const std::vector<double>& getBounds() const { return bounds; }
+    // Observations in bucket i alone (not cumulative); i == bounds.size() is +Inf.
+    uint64_t getBucketCount(size_t i) const { return counts[i].load(std::memory_order_relaxed); }
+
+private:
+    std::vector<double> bounds;
+    std::unique_ptr<std::atomic<uint64_t>[]> counts;
+    std::atomic<double> sum{0.0};
+};
+
+// Observes the lifetime of a scope, in seconds.
+class MetricTimer {
+public:
+    explicit MetricTimer(MetricHistogram& histogram)
+        : histogram(histogram)
+        , start(std::chrono::steady_clock::now()) {}
+    ~MetricTimer() {
+        histogram.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    MetricTimer(const MetricTimer&) = delete;
+    MetricTimer& operator=(const MetricTimer&) = delete;
+
+private:
+    MetricHistogram& histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+class MetricsRegistry {
+public:
+    static MetricsRegistry& global();
+
+    // Returns the metric registered under `name`, creating it on first use.
+    // A name belongs to one metric type; names follow Prometheus rules.
+    MetricCounter& counter(const std::string& name, const std::string& help);
+    MetricGauge& gauge(const std::string& name, const std::string& help);
+    MetricHistogram& histogram(const std::string& name, const std::string& help,
+                               const std::vector<double>& bounds);
+
+    // Bucket bounds for durations in seconds, 0.1 ms to 60 s.
+    static std::vector<double> latencyBuckets();
+
+    void writePrometheus(std::ostream& out) const;
+    // {"counters":{..},"gauges":{..},"histograms":{"name":{"count","sum","p50","p90","p99","buckets"}}}
+    void writeJson(std::ostream& out) const;
+    // Writes JSON if `path` ends in ".json", Prometheus text otherwise. The
+    // file is replaced atomically, so a scraper never reads half a dump.
+    bool dump(const std::string& path) const;
+
+private:
+    enum class Type { COUNTER, GAUGE, HISTOGRAM };
+
+    struct Entry {
+        std::string name;
+        std::string help;
+        Type type;
+        std::unique_ptr<MetricCounter> counter;
+        std::unique_ptr<MetricGauge> gauge;
+        std::unique_ptr<MetricHistogram> histogram;
+    };
+
+    Entry* find(const std::string& name, Type type);
+
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Entry>> entries;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,12 @@
+#ifndef MOVENOTATION_H
+#define MOVENOTATION_H
+
+#include <string>
+#include <utility>
+
+// Text form of a move: column letter and 1-based row, so "h8" is the centre
+// of the 15x15 board. Used by the engine protocol, the service and book files.
+std::string formatMove(const std::pair<int, int>& move);
+bool parseMove(const std::string& text, std::pair<int, int>& move);
+
+#endif // MOVENOTATION_H
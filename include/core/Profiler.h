@@ -0,0 +1,86 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Scoped timing zones for profiling the engine and the UI:
+//
+//   int GameAI::minimax(...) {
+//       PROFILE_ZONE("minimax");
+//       ...
+//
+// Zones only exist in builds with CONNECT6_PROFILING defined (the
+// ENABLE_PROFILING CMake option); otherwise PROFILE_ZONE expands to nothing.
+// In profiling builds a zone costs one relaxed load while recording is off,
+// and two clock reads plus a ring buffer write while it is on.
+//
+// PROFILE_DETAIL_ZONE marks zones that run many times per search node
+// (pattern scans, move scoring). They are only recorded at DETAILED level,
+// since they would otherwise push everything else out of the rings and
+// triple the search time.
+//
+// Each thread records into its own ring buffer, so zones never contend. A
+// full ring overwrites its oldest events: an export holds the most recent
+// RING_CAPACITY zones of every thread.
+class Profiler {
+public:
+    static const size_t RING_CAPACITY = size_t(1) << 18;
+
+    enum Level { OFF, ZONES, DETAILED };
+
+    static void setLevel(Level level);
+    static bool isRecording(Level zoneLevel) { return level.load(std::memory_order_relaxed) >= zoneLevel; }
+
+    // Nanoseconds on a steady clock, counted from the first call in the process.
+    static uint64_t now();
+    static void record(const char* name, uint64_t beginNs, uint64_t endNs);
+    // Names the calling thread in exported traces ("search", "ui", ...).
+    // Does nothing while recording is off.
+    static void setThreadName(const std::string& name);
+
+    // Writes every thread's recorded zones as Chrome trace event JSON, which
+    // chrome://tracing and ui.perfetto.dev open directly. Safe while other
+    // threads keep recording; events overwritten during the copy are dropped.
+    static void exportChromeTrace(std::ostream& out);
+    static bool exportChromeTrace(const std::string& path);
+    // Drops all recorded events. Buffers are kept for reuse.
+    static void clear();
+
+private:
+    static std::atomic<int> level;
+};
+
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name, Profiler::Level zoneLevel = Profiler::ZONES)
+        : name(name)
+        , beginNs(Profiler::isRecording(zoneLevel) ? Profiler::now() : 0) {}
+    ~ProfileZone() {
+        if (beginNs != 0) Profiler::record(name, beginNs, Profiler::now());
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name;
+    uint64_t beginNs;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if defined(CONNECT6_PROFILING)
+// `name` must be a string literal or otherwise outlive the export.
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_DETAIL_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name, Profiler::DETAILED)
+#else
+#define PROFILE_ZONE(name) do {} while (0)
+#define PROFILE_DETAIL_ZONE(name) do {} while (0)
+#endif
+
+#endif // PROFILER_H
@@ -0,0 +1,83 @@
+#ifndef SPARSEBOARD_H
+#define SPARSEBOARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "core/GameState.h"
+#include "core/Player.h"
+
+// Board for sizes GameBoard's fixed 15x15 array does not cover: any square
+// size, or no edge at all. Stones live in 8x8 chunks, each two 64-bit masks,
+// found through a hash map, so memory and every query grow with the stones
+// played, not with the board's area:
+//
+// - makeMove()/undoMove() read the eleven cells along each line through the
+//   stone, for the win check and the evaluation update
+// - getCandidates() spreads each chunk's masks over its neighbours
+// - evaluate() is a stored sum, kept up to date by every move
+//
+// The evaluation counts six-cell windows holding stones of one colour only,
+// scored by how many they hold; a window with both colours is dead.
+// Coordinates are rows and columns from 0 to size - 1, or any int when the
+// board is unbounded; the first move of an unbounded game is expected near 0.
+class SparseBoard {
+public:
+    static const int UNBOUNDED = 0;
+    static const int WIN_LENGTH = 6;
+    static const int CHUNK_BITS = 3;
+    static const int CHUNK_SIZE = 1 << CHUNK_BITS;
+    // Score of an open window by the stones in it; six is a win.
+    static const int64_t WINDOW_SCORES[WIN_LENGTH + 1];
+
+    explicit SparseBoard(int size = UNBOUNDED);
+
+    int getSize() const;
+    bool isOnBoard(int row, int col) const;
+    Player getCell(int row, int col) const;
+    Player getCurrentPlayer() const;
+    GameState getGameState() const;
+    int getMoveCount() const;
+    const std::vector<std::pair<int, int>>& getMoves() const;
+    // Zobrist-style hash of the stones, mixed from coordinates rather than a
+    // table, since an unbounded board has no fixed set of cells.
+    uint64_t getHash() const;
+    size_t getChunkCount() const;
+
+    // Plays a stone for the side to move; false if the cell is taken, off the
+    // board or the game is over.
+    bool makeMove(int row, int col);
+    void undoMove();
+    void reset();
+
+    // Empty cells within two steps of a stone, each once, in row-major order;
+    // the center (or 0, 0) on an empty board.
+    void getCandidates(std::vector<std::pair<int, int>>& cells) const;
+    // Open-window score of `player` minus the opponent's.
+    int64_t evaluate(Player player) const;
+
+private:
+    struct Chunk {
+        uint64_t stones[2] = {0, 0};
+    };
+
+    static uint64_t chunkKey(int row, int col);
+    static uint64_t chunkKeyOf(int chunkRow, int chunkCol);
+    static uint64_t stoneKey(int row, int col, Player player);
+    // Adds `sign` times the change a stone of `player` at (row, col) makes to
+    // the window scores; the cell must be empty when this is called.
+    void updateWindows(int row, int col, Player player, int sign);
+    bool makesSix(int row, int col, Player player) const;
+
+    int size;
+    std::unordered_map<uint64_t, Chunk> chunks;
+    std::vector<std::pair<int, int>> moves;
+    Player currentPlayer;
+    GameState gameState;
+    uint64_t hash;
+    int64_t windowScores[2];
+};
+
+#endif // SPARSEBOARD_H
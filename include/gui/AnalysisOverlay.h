@@ -0,0 +1,30 @@
+#ifndef ANALYSISOVERLAY_H
+#define ANALYSISOVERLAY_H
+
+#include <QWidget>
+#include "ai/GameAI.h"
+
+class QGridLayout;
+
+// Transparent layer over the board cells that draws the latest analysis: a
+// heatmap of root-move scores, the principal variation numbered in order,
+// and the depth reached. Mouse events pass through to the cells.
+class AnalysisOverlay : public QWidget {
+    Q_OBJECT
+
+public:
+    AnalysisOverlay(QGridLayout* grid, QWidget* parent);
+
+    void setAnalysis(const AnalysisInfo& info);
+    void clear();
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    QGridLayout* grid;
+    AnalysisInfo analysis;
+};
+
+#endif // ANALYSISOVERLAY_H
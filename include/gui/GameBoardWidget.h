@@ -10,7 +10,12 @@
 #include <QPropertyAnimation>
 #include <QComboBox>
 #include "core/GameBoard.h"
+#include "core/GameTimeline.h"
 #include "ai/GameAI.h"
+#include "ai/PonderSearch.h"
+#include "ai/BackgroundSearch.h"
+#include "ai/HintService.h"
+#include "ai/AnalysisChannel.h"
 
 class QVBoxLayout;
 class QHBoxLayout;
@@ -18,6 +23,9 @@ class QGridLayout;
 class QPushButton;
 class QLabel;
 class QComboBox;
+class QSlider;
+class QTimer;
+class AnalysisOverlay;
 
 class GameBoardWidget : public QWidget {
     Q_OBJECT
@@ -30,6 +38,7 @@ public:
     void setGameMode(int mode);
     void setHumanPlayer(Player player);
     void setAIDifficulty(AIDifficulty difficulty);
+    void setAIEngine(AIEngine engine);
 
 signals:
     void returnToMainMenu();
@@ -48,11 +57,26 @@ private slots:
     void onAIDifficultyChanged(int index);
     void onPauseClicked();
     void highlightWinningLine();
+    void onAnalyzeToggled(bool enabled);
+    void pollAnalysis();
+    void onTimelineMoved(int ply);
 
 private:
+    // The overlay repaints at most this often, however fast the search reports.
+    static const int ANALYSIS_UPDATES_PER_SECOND = 10;
+
     GameBoard* board;
     GameAI* ai;
     GameAI* ai2;  // Second AI for AI vs AI mode
+    PonderSearch* ponder;  // Searches ai's next move while the human thinks
+    HintService* hints;    // Analyses the human's position in the background
+    BackgroundSearch* search;  // The AI's move, off the GUI thread
+    int searchGeneration;  // Counts searches started and cancelled; see makeAIMove()
+    AnalysisChannel analysisChannel;
+    AnalysisOverlay* analysisOverlay;
+    QTimer* analysisTimer;
+    QTimer* aiMoveTimer;    // pending makeAIMove(); a seek cancels it
+    QWidget* boardContainer;
     QGridLayout* gridLayout;
     QVBoxLayout* mainLayout;
     QHBoxLayout* controlLayout;
@@ -63,18 +87,33 @@ private:
     QPushButton* resetButton;
     QPushButton* menuButton;
     QPushButton* pauseButton;
+    QPushButton* analyzeButton;
     QLabel* gameModeLabel;
     QLabel* difficultyLabel;
     QLabel* currentPlayerLabel;
     QComboBox* difficultyComboBox;
     QComboBox* ai2DifficultyComboBox; 
     QPushButton* hintCell;
+    // Every move of the game, so the slider can show any earlier position
+    // and come back; a move played from an earlier position drops the rest.
+    GameTimeline timeline;
+    QSlider* timelineSlider;
+    QLabel* timelineLabel;
+    Player shownCells[GameBoard::BOARD_SIZE][GameBoard::BOARD_SIZE];  // as last styled
     int gameMode;
     Player humanPlayer;
 
     void setupUI();
     void setupConnections();
     void updateStatus();
+    void playAIMove(int row, int col);
+    void onAIMoveFound(int generation, std::pair<int, int> move);
+    void cancelSearches();
+    void scheduleAIMove(int delayMs);
+    bool isAIToMove() const;
+    void refreshHints();
+    void restyleCell(int row, int col);
+    void syncTimeline();
 };
 
 #endif // GAMEBOARDWIDGET_H 
\ No newline at end of file
@@ -15,7 +15,7 @@ public:
     explicit MainMenuWidget(QWidget* parent = nullptr);
 
 signals:
-    void startGameClicked(int gameMode, int difficulty, bool playAsBlack);
+    void startGameClicked(int gameMode, int difficulty, bool playAsBlack, int engine);
     void exitClicked();
 
 private slots:
@@ -26,6 +26,7 @@ private:
     QPushButton* exitButton;
     QComboBox* gameModeCombo;
     QComboBox* difficultyCombo;
+    QComboBox* engineCombo;
     QComboBox* colorCombo;
     QVBoxLayout* layout;
 };
@@ -15,11 +15,24 @@ public:
     explicit MainWindow(QWidget* parent = nullptr);
     ~MainWindow();
 
+signals:
+    // The main menu has reached the screen for the first time.
+    void firstFrame();
+    void boardViewReady();
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
 private slots:
-    void startGame(int gameMode, int difficulty, bool playAsBlack);
+    void startGame(int gameMode, int difficulty, bool playAsBlack, int engine);
     void showMainMenu();
+    void onFirstFrame();
 
 private:
+    // The board view and its engines are built on first use, or as soon as
+    // the menu's first frame is on screen, so they never delay that frame.
+    GameBoardWidget* boardView();
+
     QStackedWidget* stackedWidget;
     MainMenuWidget* mainMenu;
     GameBoard* gameBoard;
@@ -0,0 +1,97 @@
+#ifndef ENGINEPROTOCOL_H
+#define ENGINEPROTOCOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include "ai/GameAI.h"
+#include "core/GameBoard.h"
+#include "core/Player.h"
+
+// Limits of one "go" command. Zero means "not given".
+struct SearchLimits {
+    int blackTimeMs = 0;
+    int whiteTimeMs = 0;
+    int blackIncrementMs = 0;
+    int whiteIncrementMs = 0;
+    int movesToGo = 0;
+    int moveTimeMs = 0;
+    int depth = 0;
+    bool infinite = false;
+    bool ponder = false;
+};
+
+// Line-based engine protocol modelled on UCI, for match managers and batch
+// tools. Moves use MoveNotation ("h8" is the centre); Black moves first.
+//
+//   uci                      -> id, options, uciok
+//   isready                  -> readyok
+//   ucinewgame
+//   setoption name <Difficulty|Engine|MultiPV|Hash> value <value>
+//   position <startpos | file <path>> [moves <m1> <m2> ...]
+//   go [ponder] [btime <ms>] [wtime <ms>] [binc <ms>] [winc <ms>]
+//      [movestogo <n>] [movetime <ms>] [depth <n>] [infinite]
+//                            -> info ... lines, then bestmove <move> [ponder <move>]
+//   ponderhit                -> the ponder search continues as a normal one
+//   stop                     -> bestmove within milliseconds
+//   quit
+//
+// Searches run on a worker thread, so the input loop stays responsive; every
+// output line is written whole under a lock.
+class EngineProtocol {
+public:
+    EngineProtocol(std::istream& in, std::ostream& out);
+    ~EngineProtocol();
+
+    // Reads commands until "quit" or end of input.
+    int run();
+    // Returns false once the engine should exit.
+    bool handleCommand(const std::string& line);
+
+    // Time to spend on this move; 0 when the search has no time limit.
+    static int moveBudgetMs(const SearchLimits& limits, Player player);
+
+private:
+    static const int MAX_SEARCH_DEPTH = 32;
+    static const int DEFAULT_MOVES_TO_GO = 30;
+    static const int MOVE_OVERHEAD_MS = 30;
+    static const int MAX_MULTI_PV = 10;
+    static const int MAX_HASH_MB = 65536;
+
+    void send(const std::string& line);
+    void setOption(const std::string& name, const std::string& value);
+    void setPosition(std::istringstream& args);
+    void startSearch(std::istringstream& args);
+    void stopSearch();
+    void ponderHit();
+    void search();
+    void runTimer();
+    void reportProgress(const AnalysisInfo& info, std::pair<int, int>& lastBest, int& lastDepth);
+    int defaultDepth() const;
+
+    std::istream& in;
+    std::ostream& out;
+    std::mutex outputMutex;
+    GameAI ai;
+    GameBoard board;
+    GameBoard position;     // copy of `board` owned by the running search
+    SearchLimits limits;
+    int multiPV;            // ranked lines reported per depth
+
+    std::thread worker;
+    std::thread timer;
+    std::mutex searchMutex;
+    std::condition_variable searchChanged;
+    bool searching;
+    bool pondering;
+    int budgetMs;
+    std::chrono::steady_clock::time_point searchStart;
+    std::chrono::steady_clock::time_point deadline;
+    bool timed;
+};
+
+#endif // ENGINEPROTOCOL_H
@@ -0,0 +1,131 @@
+#ifndef GAMESERVICE_H
+#define GAMESERVICE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "ai/GameAI.h"
+#include "ai/OpeningBook.h"
+#include "core/GameBoard.h"
+
+struct ServiceConfig {
+    int workers = 0;                // 0: one per hardware thread
+    int defaultBudgetMs = 200;      // per "go" without movetime
+    int maxBudgetMs = 10000;
+    size_t maxSessions = 100000;
+};
+
+struct ServiceStats {
+    uint64_t sessionsOpened = 0;
+    uint64_t sessionsClosed = 0;
+    uint64_t requests = 0;
+    uint64_t searches = 0;
+    uint64_t bookMoves = 0;
+    uint64_t rejected = 0;          // malformed requests and unknown sessions
+    size_t openSessions = 0;
+    size_t queuedSessions = 0;
+};
+
+using ServiceReply = std::function<void(const std::string&)>;
+
+// Hosts many games on a fixed pool of search workers. One text command per
+// call; replies start with the session id because requests of different
+// sessions finish out of order:
+//
+//   new [easy|medium|hard]       -> new <id>
+//   move <id> <move>             -> <id> ok | <id> error ...
+//   go <id> [movetime <ms>]      -> <id> bestmove <move> state <state>
+//   show <id>                    -> <id> moves <m1> <m2> ... state <state>
+//   close <id>                   -> <id> closed
+//   stats                        -> stats ...
+//
+// A session is only its move list; workers replay it on their own board, so
+// idle sessions cost a few hundred bytes. Requests of one session run in
+// order, and sessions with pending work are served round robin, one request
+// per turn, so a busy client cannot starve the others. Every search has a
+// time budget enforced by a watchdog thread.
+class GameService {
+public:
+    explicit GameService(const ServiceConfig& config = ServiceConfig(),
+                         std::shared_ptr<const OpeningBook> book = OpeningBook::shared());
+    ~GameService();
+
+    // Thread-safe. `reply` is called exactly once, possibly on a worker thread;
+    // requests still queued when the service is destroyed are answered
+    // "<id> error shutting down".
+    void handle(const std::string& line, const ServiceReply& reply);
+    ServiceStats getStats() const;
+
+private:
+    static const int MAX_MOVES = GameBoard::BOARD_SIZE * GameBoard::BOARD_SIZE;
+    static const int SLOT_BITS = 20;
+
+    struct Session {
+        uint16_t generation = 0;
+        bool open = false;
+        bool queued = false;        // has pending requests and is in the ready queue or running
+        uint8_t difficulty = 1;
+        uint8_t moveCount = 0;
+        uint8_t moves[MAX_MOVES];   // row * BOARD_SIZE + col
+    };
+
+    enum class Command { MOVE, GO, SHOW, CLOSE };
+
+    struct Request {
+        Command command;
+        uint32_t id;
+        int argument;               // cell for MOVE, budget in ms for GO
+        ServiceReply reply;
+    };
+
+    struct Worker {
+        GameAI ai;
+        GameBoard board;
+        std::thread thread;
+        bool timed = false;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    uint32_t openSession(int difficulty);
+    bool lookup(uint32_t id, uint32_t& slot) const;
+    void enqueue(uint32_t slot, Request request);
+    void runWorker(Worker& worker);
+    std::string process(Worker& worker, Session& session, const Request& request);
+    std::pair<int, int> search(Worker& worker, int difficulty, int budgetMs);
+    void runWatchdog();
+    static std::string stateName(GameState state);
+
+    ServiceConfig config;
+    std::shared_ptr<const OpeningBook> book;
+
+    mutable std::mutex mutex;
+    std::condition_variable ready;
+    std::vector<Session> sessions;
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<uint32_t, std::deque<Request>> pending;  // by slot
+    std::deque<uint32_t> readySlots;
+    bool stopping;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::mutex timerMutex;
+    std::condition_variable timerChanged;
+    std::thread watchdog;
+
+    std::atomic<uint64_t> requests;
+    std::atomic<uint64_t> searches;
+    std::atomic<uint64_t> bookMoves;
+    std::atomic<uint64_t> rejected;
+    uint64_t sessionsOpened;
+    uint64_t sessionsClosed;
+};
+
+#endif // GAMESERVICE_H
@@ -0,0 +1,290 @@
+// Headless game service on a Unix domain socket.
+//
+//   connect6_server [--socket <path>] [--workers <n>] [--budget <ms>] [--max-budget <ms>]
+//                   [--metrics <path>]
+//
+// Clients send GameService commands, one per line, and may pipeline any
+// number of them; replies are written as lines in completion order. The
+// sessions a client opened are closed when it disconnects.
+//
+// With --metrics, every connection to that second socket receives the
+// metrics registry in Prometheus text format and is closed, e.g.
+// `socat - UNIX-CONNECT:/tmp/connect6-metrics.sock`.
+
+#include "service/GameService.h"
+#include "ai/NNUEEvaluator.h"
+#include "ai/PatternEvaluator.h"
+#include "core/Metrics.h"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// A client whose unsent replies pass this is not read from until it reads
+// them, so one that only writes cannot grow its buffer without bound.
+const size_t MAX_UNSENT_BYTES = 1 << 20;
+
+// Replies may outlive the connection they answer, so the descriptor is
+// closed with the last reference. Sockets are non-blocking: workers only
+// append replies to `output` and wake the poll loop, which sends them as
+// fast as the client reads, so a client that stops reading stalls nobody
+// but itself.
+struct Connection {
+    int fd;
+    int wakeFd;
+    bool closeWhenSent;             // metrics connections: one reply, then close
+    std::string input;              // poll thread only
+    std::mutex mutex;               // guards the members below
+    std::string output;
+    std::vector<uint32_t> sessions; // opened here and not yet closed
+    bool connected;
+
+    Connection(int fd, int wakeFd, bool closeWhenSent = false)
+        : fd(fd), wakeFd(wakeFd), closeWhenSent(closeWhenSent), connected(true) {}
+    ~Connection() { close(fd); }
+
+    void write(const std::string& line) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!connected) return;
+        output += line;
+        output += '\n';
+        // A full pipe means a wake-up is already pending.
+        char byte = 0;
+        if (::write(wakeFd, &byte, 1) < 0) return;
+    }
+
+    // Sessions are listed when the reply to `new` names them, and unlisted
+    // as soon as the client asks to close them.
+    void opened(const std::string& reply) {
+        if (reply.compare(0, 4, "new ") != 0) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        sessions.push_back(static_cast<uint32_t>(std::strtoul(reply.c_str() + 4, nullptr, 10)));
+    }
+
+    void closing(const std::string& line) {
+        if (line.compare(0, 6, "close ") != 0) return;
+        uint32_t id = static_cast<uint32_t>(std::strtoul(line.c_str() + 6, nullptr, 10));
+        std::lock_guard<std::mutex> lock(mutex);
+        sessions.erase(std::remove(sessions.begin(), sessions.end(), id), sessions.end());
+    }
+
+    // Sends what the socket accepts now; false once the client is gone.
+    bool flush() {
+        std::lock_guard<std::mutex> lock(mutex);
+        while (!output.empty()) {
+            ssize_t n = ::send(fd, output.data(), output.size(), 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+            if (n <= 0) return false;
+            output.erase(0, static_cast<size_t>(n));
+        }
+        return true;
+    }
+
+    size_t unsent() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return output.size();
+    }
+
+    // Drops unsent replies and hands back the sessions left open.
+    std::vector<uint32_t> disconnect() {
+        std::lock_guard<std::mutex> lock(mutex);
+        connected = false;
+        output.clear();
+        std::vector<uint32_t> open;
+        open.swap(sessions);
+        return open;
+    }
+};
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+int openListener(const std::string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        close(fd);
+        return -1;
+    }
+    std::strcpy(address.sun_path, path.c_str());
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, 128) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+std::shared_ptr<Connection> acceptClient(int listener, int wakeFd, bool closeWhenSent) {
+    int fd = ::accept(listener, nullptr, nullptr);
+    if (fd < 0) return nullptr;
+    if (!setNonBlocking(fd)) {
+        close(fd);
+        return nullptr;
+    }
+    return std::make_shared<Connection>(fd, wakeFd, closeWhenSent);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path = "/tmp/connect6.sock";
+    std::string metricsPath;
+    ServiceConfig config;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        if (option == "--socket") path = argv[i + 1];
+        else if (option == "--workers") config.workers = std::atoi(argv[i + 1]);
+        else if (option == "--budget") config.defaultBudgetMs = std::atoi(argv[i + 1]);
+        else if (option == "--max-budget") config.maxBudgetMs = std::atoi(argv[i + 1]);
+        else if (option == "--metrics") metricsPath = argv[i + 1];
+        else {
+            std::cerr << "unknown option " << option << std::endl;
+            return 2;
+        }
+    }
+
+    // A client that disconnects with replies in flight must not kill the server.
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // Loaded once here; every worker shares the same read-only tables.
+    PatternWeights::shared();
+    NNUEWeights::shared();
+    GameService service(config);
+
+    int listener = openListener(path);
+    if (listener < 0) {
+        std::cerr << "cannot listen on " << path << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    std::cout << "listening on " << path << std::endl;
+
+    int metricsListener = -1;
+    if (!metricsPath.empty()) {
+        metricsListener = openListener(metricsPath);
+        if (metricsListener < 0) {
+            std::cerr << "cannot listen on " << metricsPath << ": " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+        std::cout << "metrics on " << metricsPath << std::endl;
+    }
+
+    // Workers write a byte here after queuing a reply, to wake poll().
+    int wake[2];
+    if (pipe(wake) < 0 || !setNonBlocking(wake[0]) || !setNonBlocking(wake[1])) {
+        std::cerr << "cannot create wake-up pipe: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    std::unordered_map<int, std::shared_ptr<Connection>> connections;
+    // A client that leaves takes its sessions with it; in-flight replies
+    // still hold the connection, but are dropped.
+    auto drop = [&](int fd) {
+        for (uint32_t id : connections[fd]->disconnect()) {
+            service.handle("close " + std::to_string(id), [](const std::string&) {});
+        }
+        connections.erase(fd);
+    };
+    std::vector<pollfd> polled;
+    char buffer[4096];
+    while (true) {
+        polled.assign(1, pollfd{listener, POLLIN, 0});
+        polled.push_back(pollfd{metricsListener, POLLIN, 0});    // ignored by poll() when -1
+        polled.push_back(pollfd{wake[0], POLLIN, 0});
+        for (const auto& entry : connections) {
+            size_t unsent = entry.second->unsent();
+            short events = 0;
+            if (!entry.second->closeWhenSent && unsent < MAX_UNSENT_BYTES) events |= POLLIN;
+            if (unsent > 0) events |= POLLOUT;
+            polled.push_back(pollfd{entry.first, events, 0});
+        }
+        if (poll(polled.data(), polled.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (polled[0].revents & POLLIN) {
+            if (std::shared_ptr<Connection> connection = acceptClient(listener, wake[1], false)) {
+                connections[connection->fd] = connection;
+            }
+        }
+        if (polled[1].revents & POLLIN) {
+            if (std::shared_ptr<Connection> connection = acceptClient(metricsListener, wake[1], true)) {
+                std::ostringstream text;
+                MetricsRegistry::global().writePrometheus(text);
+                connection->write(text.str());
+                connections[connection->fd] = connection;
+            }
+        }
+        if (polled[2].revents & POLLIN) {
+            while (read(wake[0], buffer, sizeof(buffer)) > 0) {}
+        }
+        for (size_t i = 3; i < polled.size(); ++i) {
+            int fd = polled[i].fd;
+            std::shared_ptr<Connection> connection = connections[fd];
+            if (polled[i].revents & POLLOUT) {
+                if (!connection->flush()) {
+                    drop(fd);
+                    continue;
+                }
+                if (connection->closeWhenSent && connection->unsent() == 0) {
+                    drop(fd);
+                    continue;
+                }
+            }
+            if (!(polled[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            ssize_t n = connection->closeWhenSent ? 0 : read(fd, buffer, sizeof(buffer));
+            if (n < 0 && (errno == EAGAIN || errno == EINTR)) continue;
+            if (n <= 0) {
+                drop(fd);
+                continue;
+            }
+            connection->input.append(buffer, static_cast<size_t>(n));
+            size_t start = 0;
+            size_t end;
+            while ((end = connection->input.find('\n', start)) != std::string::npos) {
+                std::string line = connection->input.substr(start, end - start);
+                start = end + 1;
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                if (line.empty()) continue;
+                connection->closing(line);
+                service.handle(line, [connection](const std::string& reply) {
+                    connection->opened(reply);
+                    connection->write(reply);
+                });
+            }
+            connection->input.erase(0, start);
+        }
+    }
+
+    for (auto& entry : connections) entry.second->disconnect();
+    close(wake[0]);
+    close(wake[1]);
+    close(listener);
+    unlink(path.c_str());
+    if (metricsListener >= 0) {
+        close(metricsListener);
+        unlink(metricsPath.c_str());
+    }
+    return 0;
+}
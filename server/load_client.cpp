@@ -0,0 +1,201 @@
+// Load generator for connect6_server.
+//
+//   connect6_load [--socket <path>] [--connections <n>] [--sessions <n>]
+//                 [--plies <n>] [--movetime <ms>] [--difficulty easy|medium|hard]
+//
+// Opens `sessions` games spread over `connections` connections and keeps one
+// "go" request in flight per game, so the server always has `sessions`
+// requests queued. Every game plays `plies` engine moves (or until it ends);
+// then latency percentiles and throughput are printed.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string path = "/tmp/connect6.sock";
+    int connections = 4;
+    int sessions = 1000;
+    int plies = 10;
+    int moveTimeMs = 20;
+    std::string difficulty = "easy";
+};
+
+class LineSocket {
+public:
+    explicit LineSocket(const std::string& path) : fd(socket(AF_UNIX, SOCK_STREAM, 0)) {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    ~LineSocket() { if (fd >= 0) close(fd); }
+
+    bool isOpen() const { return fd >= 0; }
+
+    void send(const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, 0);
+            if (n <= 0) return;
+            sent += static_cast<size_t>(n);
+        }
+    }
+
+    bool readLine(std::string& line) {
+        size_t end;
+        while ((end = buffer.find('\n')) == std::string::npos) {
+            char chunk[4096];
+            ssize_t n = read(fd, chunk, sizeof(chunk));
+            if (n <= 0) return false;
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+        line = buffer.substr(0, end);
+        buffer.erase(0, end + 1);
+        return true;
+    }
+
+private:
+    int fd;
+    std::string buffer;
+};
+
+struct ConnectionResult {
+    std::vector<double> latenciesMs;
+    int games = 0;
+    int finished = 0;
+    int errors = 0;
+};
+
+void runConnection(const Options& options, int sessions, ConnectionResult& result) {
+    LineSocket socket(options.path);
+    if (!socket.isOpen()) {
+        result.errors++;
+        return;
+    }
+
+    // Open every session up front (pipelined), then start all games at once.
+    std::string batch;
+    for (int i = 0; i < sessions; ++i) batch += "new " + options.difficulty + "\n";
+    socket.send(batch);
+
+    std::unordered_map<uint32_t, int> plies;
+    std::unordered_map<uint32_t, Clock::time_point> sentAt;
+    std::string line;
+    for (int i = 0; i < sessions && socket.readLine(line); ++i) {
+        uint32_t id;
+        if (std::sscanf(line.c_str(), "new %u", &id) != 1) {
+            result.errors++;
+            continue;
+        }
+        plies[id] = 0;
+    }
+    result.games = static_cast<int>(plies.size());
+
+    std::string go = " movetime " + std::to_string(options.moveTimeMs) + "\n";
+    batch.clear();
+    auto now = Clock::now();
+    for (const auto& entry : plies) {
+        batch += "go " + std::to_string(entry.first) + go;
+        sentAt[entry.first] = now;
+    }
+    socket.send(batch);
+
+    size_t active = plies.size();
+    while (active > 0 && socket.readLine(line)) {
+        std::istringstream words(line);
+        uint32_t id;
+        std::string kind, move, stateKey, state;
+        if (words >> id >> kind && kind == "closed") continue;
+        if (kind != "bestmove") {
+            result.errors++;
+            continue;
+        }
+        words >> move >> stateKey >> state;
+        auto finished = Clock::now();
+        result.latenciesMs.push_back(std::chrono::duration<double, std::milli>(finished - sentAt[id]).count());
+
+        int& played = plies[id];
+        played++;
+        if (state != "in_progress" || played >= options.plies) {
+            if (state != "in_progress") result.finished++;
+            socket.send("close " + std::to_string(id) + "\n");
+            active--;
+            continue;
+        }
+        sentAt[id] = finished;
+        socket.send("go " + std::to_string(id) + go);
+    }
+}
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    size_t index = static_cast<size_t>(fraction * (sorted.size() - 1));
+    return sorted[index];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        if (option == "--socket") options.path = argv[i + 1];
+        else if (option == "--connections") options.connections = std::max(1, std::atoi(argv[i + 1]));
+        else if (option == "--sessions") options.sessions = std::max(1, std::atoi(argv[i + 1]));
+        else if (option == "--plies") options.plies = std::max(1, std::atoi(argv[i + 1]));
+        else if (option == "--movetime") options.moveTimeMs = std::max(1, std::atoi(argv[i + 1]));
+        else if (option == "--difficulty") options.difficulty = argv[i + 1];
+        else {
+            std::cerr << "unknown option " << option << std::endl;
+            return 2;
+        }
+    }
+
+    std::vector<ConnectionResult> results(options.connections);
+    std::vector<std::thread> threads;
+    auto start = Clock::now();
+    for (int i = 0; i < options.connections; ++i) {
+        int sessions = options.sessions / options.connections + (i < options.sessions % options.connections ? 1 : 0);
+        threads.emplace_back(runConnection, std::cref(options), sessions, std::ref(results[i]));
+    }
+    for (auto& thread : threads) thread.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<double> latencies;
+    int games = 0, finished = 0, errors = 0;
+    for (const auto& result : results) {
+        latencies.insert(latencies.end(), result.latenciesMs.begin(), result.latenciesMs.end());
+        games += result.games;
+        finished += result.finished;
+        errors += result.errors;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    std::printf("games %d (finished %d), requests %zu, errors %d, %.2f s\n",
+                games, finished, latencies.size(), errors, seconds);
+    std::printf("throughput %.1f moves/s\n", latencies.size() / seconds);
+    std::printf("latency ms: p50 %.1f  p95 %.1f  p99 %.1f  max %.1f\n",
+                percentile(latencies, 0.50), percentile(latencies, 0.95),
+                percentile(latencies, 0.99), latencies.empty() ? 0.0 : latencies.back());
+    return errors == 0 ? 0 : 1;
+}
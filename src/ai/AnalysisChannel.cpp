@@ -0,0 +1,34 @@
+#include "ai/AnalysisChannel.h"
+
+void AnalysisChannel::publish(const AnalysisInfo& info) {
+    std::lock_guard<std::mutex> lock(mutex);
+    // Assignment reuses the vectors' storage, so steady-state publishing does not allocate.
+    latest = info;
+    fresh = true;
+    published++;
+}
+
+bool AnalysisChannel::take(AnalysisInfo& info) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!fresh) return false;
+    info = latest;
+    fresh = false;
+    delivered++;
+    return true;
+}
+
+void AnalysisChannel::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    latest = AnalysisInfo();
+    fresh = true;
+}
+
+uint64_t AnalysisChannel::getPublished() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return published;
+}
+
+uint64_t AnalysisChannel::getDelivered() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return delivered;
+}
@@ -0,0 +1,47 @@
+#include "ai/BackgroundSearch.h"
+#include "core/Profiler.h"
+
+BackgroundSearch::BackgroundSearch()
+    : ai(nullptr)
+    , channel(nullptr) {
+}
+
+BackgroundSearch::~BackgroundSearch() {
+    cancel();
+}
+
+void BackgroundSearch::start(GameAI& engine, const GameBoard& board, AnalysisChannel* analysis,
+                             const DoneCallback& callback) {
+    cancel();
+    if (board.getGameState() != GameState::IN_PROGRESS) return;
+
+    ai = &engine;
+    position = board;
+    channel = analysis;
+    done = callback;
+    if (channel) channel->clear();
+    ai->clearStopRequest();
+    worker = std::thread(&BackgroundSearch::run, this);
+}
+
+void BackgroundSearch::run() {
+    Profiler::setThreadName("ai search");
+    if (channel) {
+        AnalysisChannel* target = channel;
+        ai->setProgressCallback([target](const AnalysisInfo& info) { target->publish(info); });
+    }
+    std::pair<int, int> move = ai->getBestMove(position, position.getCurrentPlayer());
+    ai->setProgressCallback(AnalysisCallback());
+    if (!ai->isStopRequested()) done(move);
+}
+
+void BackgroundSearch::cancel() {
+    if (!worker.joinable()) return;
+    ai->requestStop();
+    worker.join();
+    ai->clearStopRequest();
+}
+
+bool BackgroundSearch::isActive() const {
+    return worker.joinable();
+}
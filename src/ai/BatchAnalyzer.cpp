@@ -0,0 +1,69 @@
+#include "ai/BatchAnalyzer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+BatchAnalyzer::BatchAnalyzer(int threads) {
+    int count = threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency());
+    count = std::max(1, count);
+    for (int i = 0; i < count; ++i) {
+        engines.emplace_back(new GameAI());
+        engines.back()->setVerbose(false);
+    }
+}
+
+void BatchAnalyzer::setDifficulty(AIDifficulty difficulty) {
+    for (auto& engine : engines) engine->setDifficulty(difficulty);
+}
+
+void BatchAnalyzer::setEngine(AIEngine engine) {
+    for (auto& ai : engines) ai->setEngine(engine);
+}
+
+int BatchAnalyzer::getThreadCount() const {
+    return static_cast<int>(engines.size());
+}
+
+void BatchAnalyzer::analyze(const GameBoard* const* positions, size_t count, ScoredMove* results) {
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<size_t> next(0);
+
+    auto work = [&](GameAI& ai) {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            const GameBoard& board = *positions[i];
+            if (board.getGameState() != GameState::IN_PROGRESS) {
+                results[i] = ScoredMove{{-1, -1}, 0};
+                continue;
+            }
+            // Positions are unrelated, and each result must not depend on
+            // which engine searched which position before it.
+            ai.newGame();
+            results[i] = ai.getScoredMove(board, board.getCurrentPlayer());
+        }
+    };
+
+    // No more threads than positions; the calling thread is one of them.
+    size_t used = std::max<size_t>(1, std::min(engines.size(), count));
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < used; ++t) threads.emplace_back(work, std::ref(*engines[t]));
+    work(*engines[0]);
+    for (auto& thread : threads) thread.join();
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    lastStats.positions = count;
+    lastStats.threads = static_cast<int>(used);
+    lastStats.elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    lastStats.positionsPerSecond = seconds > 0.0 ? count / seconds : 0.0;
+}
+
+std::vector<ScoredMove> BatchAnalyzer::analyze(const std::vector<const GameBoard*>& positions) {
+    std::vector<ScoredMove> results(positions.size());
+    analyze(positions.data(), positions.size(), results.data());
+    return results;
+}
+
+const BatchStats& BatchAnalyzer::getLastStats() const {
+    return lastStats;
+}
@@ -0,0 +1,44 @@
+#include "ai/BoardWindows.h"
+#include <algorithm>
+
+BoardWindows::BoardWindows() : windowCount{} {
+    const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    const int n = GameBoard::BOARD_SIZE;
+    const int len = GameBoard::WIN_LENGTH;
+    int window = 0;
+    for (const auto& dir : directions) {
+        for (int row = 0; row < n; ++row) {
+            for (int col = 0; col < n; ++col) {
+                int endRow = row + dir[0] * (len - 1);
+                int endCol = col + dir[1] * (len - 1);
+                if (endRow < 0 || endRow >= n || endCol < 0 || endCol >= n) continue;
+
+                for (int k = 0; k < len; ++k) {
+                    int cell = (row + dir[0] * k) * n + col + dir[1] * k;
+                    cells[window][k] = static_cast<int16_t>(cell);
+                    windowsOfCell[cell][windowCount[cell]++] = static_cast<int16_t>(window);
+                }
+                window++;
+            }
+        }
+    }
+}
+
+const BoardWindows& BoardWindows::get() {
+    static const BoardWindows windows;
+    return windows;
+}
+
+void WindowStones::clear() {
+    std::fill(&counts[0][0], &counts[0][0] + 2 * BoardWindows::COUNT, 0);
+}
+
+void WindowStones::reset(const GameBoard& board) {
+    clear();
+    const BoardWindows& windows = BoardWindows::get();
+    for (int cell = 0; cell < BoardWindows::CELLS; ++cell) {
+        Player player = board.getCell(cell / GameBoard::BOARD_SIZE, cell % GameBoard::BOARD_SIZE);
+        if (player == Player::NONE) continue;
+        for (int w : windows.windowsOf(cell)) counts[colorIndex(player)][w]++;
+    }
+}
@@ -1,16 +1,119 @@
 #include "ai/GameAI.h"
+#include "core/Metrics.h"
+#include "core/Profiler.h"
 #include <algorithm>
+#include <cstdlib>
 #include <limits>
 #include <random>
 #include <chrono>
 #include <iostream>
 
-GameAI::GameAI(QObject* parent) : QObject(parent), currentDifficulty(AIDifficulty::MEDIUM) {
+namespace {
+
+const int INF = std::numeric_limits<int>::max();
+
+// Shared by every GameAI in the process. Looked up once, so publishing after
+// a search is a handful of relaxed atomic adds.
+struct SearchMetrics {
+    MetricCounter& searches;
+    MetricHistogram& seconds;
+    MetricCounter& nodes;
+    MetricCounter& solverNodes;
+    MetricGauge& nodesPerSecond;
+    MetricCounter& tableProbes;
+    MetricCounter& tableHits;
+    MetricGauge& tableFill;
+    MetricCounter& searchTableProbes;
+    MetricCounter& searchTableHits;
+    MetricGauge& searchTableFill;
+
+    static SearchMetrics& get() {
+        MetricsRegistry& registry = MetricsRegistry::global();
+        static SearchMetrics metrics{
+            registry.counter("connect6_searches_total", "Move and analysis searches completed"),
+            registry.histogram("connect6_search_seconds", "Wall time per search",
+                               MetricsRegistry::latencyBuckets()),
+            registry.counter("connect6_search_nodes_total", "Minimax nodes searched"),
+            registry.counter("connect6_solver_nodes_total", "Endgame solver nodes searched"),
+            registry.gauge("connect6_search_nodes_per_second", "Nodes per second of the last search"),
+            registry.counter("connect6_solver_table_probes_total", "Endgame solver transposition table probes"),
+            registry.counter("connect6_solver_table_hits_total", "Endgame solver transposition table hits"),
+            registry.gauge("connect6_solver_table_fill", "Fraction of the last solver's table in use"),
+            registry.counter("connect6_search_table_probes_total", "Minimax transposition table probes"),
+            registry.counter("connect6_search_table_hits_total", "Minimax transposition table hits"),
+            registry.gauge("connect6_search_table_fill", "Fraction of the last minimax table in use"),
+        };
+        return metrics;
+    }
+};
+
+// Win scores count plies from the root; the table keeps them counted from
+// the node itself, so an entry is valid wherever the position recurs.
+const int TABLE_WIN_THRESHOLD = GameAI::WIN_SCORE / 2;
+
+int toTableScore(int score, int ply) {
+    if (score > TABLE_WIN_THRESHOLD) return score + ply;
+    if (score < -TABLE_WIN_THRESHOLD) return score - ply;
+    return score;
+}
+
+int fromTableScore(int score, int ply) {
+    if (score > TABLE_WIN_THRESHOLD) return score - ply;
+    if (score < -TABLE_WIN_THRESHOLD) return score + ply;
+    return score;
+}
+
+} // namespace
+
+GameAI::GameAI(QObject* parent)
+    : QObject(parent)
+    , currentDifficulty(AIDifficulty::MEDIUM)
+    , currentEngine(AIEngine::MINIMAX)
+    , verbose(true)
+    , deterministic(false)
+    , trace(nullptr)
+    , mctsPlayoutLimit(0)
+    , mctsTimeLimitMs(0)
+    , selectiveActive(false)
+    , quiescenceDepth(DEFAULT_QUIESCENCE_DEPTH)
+    , stopRequested(false)
+    , evaluator(&patterns) {
     std::random_device rd;
     rng.seed(rd());
+    std::fill(pvLength, pvLength + MAX_PV, 0);
+    std::fill(&history[0][0], &history[0][0] + 2 * GameBoard::BOARD_SIZE * GameBoard::BOARD_SIZE, 0u);
+    solver.setStopFlag(&stopRequested);
+    mcts.setStopFlag(&stopRequested);
+    if (const char* seed = std::getenv("CONNECT6_SEED")) {
+        setSeed(std::strtoull(seed, nullptr, 10));
+    }
+    
+    if (std::shared_ptr<const PatternWeights> weights = PatternWeights::shared()) {
+        patterns.setWeights(*weights);
+    }
+    if (std::shared_ptr<const NNUEWeights> weights = NNUEWeights::shared()) {
+        setEvaluator(std::make_unique<NNUEEvaluator>(weights));
+    }
+}
+
+void GameAI::setEvaluator(std::unique_ptr<Evaluator> custom) {
+    customEvaluator = std::move(custom);
+    evaluator = customEvaluator ? customEvaluator.get() : &patterns;
+    // Stored scores came from the old evaluation.
+    table.clear();
+}
+
+bool GameAI::loadEvaluatorWeights(const std::string& path) {
+    std::shared_ptr<const NNUEWeights> weights = NNUEWeights::load(path);
+    if (!weights) return false;
+    setEvaluator(std::make_unique<NNUEEvaluator>(weights));
+    return true;
 }
 
 void GameAI::setDifficulty(AIDifficulty difficulty) {
+    // Hard stores results of pruned searches, which an exhaustive Easy or
+    // Medium search must not cut off on.
+    if (difficulty != currentDifficulty) table.clear();
     currentDifficulty = difficulty;
 }
 
@@ -18,64 +121,282 @@ AIDifficulty GameAI::getDifficulty() const {
     return currentDifficulty;
 }
 
+void GameAI::setEngine(AIEngine engine) {
+    currentEngine = engine;
+}
+
+AIEngine GameAI::getEngine() const {
+    return currentEngine;
+}
+
+void GameAI::setVerbose(bool enabled) {
+    verbose = enabled;
+}
+
+void GameAI::requestStop() {
+    stopRequested.store(true);
+}
+
+void GameAI::clearStopRequest() {
+    stopRequested.store(false);
+}
+
+bool GameAI::isStopRequested() const {
+    return stopRequested.load();
+}
+
+void GameAI::setSeed(uint64_t seed) {
+    deterministic = true;
+    rng.seed(static_cast<std::mt19937::result_type>(seed));
+    mcts.setSeed(seed);
+    mcts.setThreadCount(1);
+}
+
+bool GameAI::isDeterministic() const {
+    return deterministic;
+}
+
+void GameAI::setTrace(SearchTrace* value) {
+    trace = value;
+}
+
+void GameAI::setMCTSLimits(uint64_t maxPlayouts, int maxTimeMs) {
+    mctsPlayoutLimit = maxPlayouts;
+    mctsTimeLimitMs = maxTimeMs;
+}
+
+void GameAI::setProgressCallback(const AnalysisCallback& callback) {
+    progress = callback;
+}
+
+void GameAI::setSelectiveSearch(const SelectiveSearch& config) {
+    selective = config;
+    table.clear();
+}
+
+const SelectiveSearch& GameAI::getSelectiveSearch() const {
+    return selective;
+}
+
+void GameAI::setQuiescenceDepth(int plies) {
+    quiescenceDepth = std::max(0, plies);
+    table.clear();
+}
+
+int GameAI::getQuiescenceDepth() const {
+    return quiescenceDepth;
+}
+
+const SearchStats& GameAI::getLastSearchStats() const {
+    return searchStats;
+}
+
+void GameAI::newGame() {
+    table.clear();
+    mcts.reset();
+}
+
+void GameAI::startSearch() {
+    std::fill(&history[0][0], &history[0][0] + 2 * GameBoard::BOARD_SIZE * GameBoard::BOARD_SIZE, 0u);
+    table.newSearch();
+}
+
+void GameAI::setTableMegabytes(size_t megabytes) {
+    table.setMegabytes(megabytes);
+}
+
+uint64_t GameAI::tableKey(const GameBoard& board, Player player) const {
+    // The side to move is part of the position: searches may be asked for either side.
+    return player == Player::WHITE ? board.getHash() ^ 0x9E3779B97F4A7C15ULL : board.getHash();
+}
+
+void GameAI::publishSearchMetrics() {
+    SearchMetrics& metrics = SearchMetrics::get();
+    uint64_t nodes = searchStats.nodes + searchStats.solverNodes;
+    metrics.searches.add();
+    metrics.seconds.observe(searchStats.elapsedUs / 1e6);
+    metrics.nodes.add(searchStats.nodes);
+    if (searchStats.solverNodes > 0) {
+        metrics.solverNodes.add(searchStats.solverNodes);
+        metrics.tableProbes.add(searchStats.solverTableProbes);
+        metrics.tableHits.add(searchStats.solverTableHits);
+        metrics.tableFill.set(solver.getTableFill());
+    }
+    if (searchStats.tableProbes > 0) {
+        metrics.searchTableProbes.add(searchStats.tableProbes);
+        metrics.searchTableHits.add(searchStats.tableHits);
+        metrics.searchTableFill.set(table.getFill());
+    }
+    if (searchStats.elapsedUs > 0) metrics.nodesPerSecond.set(nodes * 1e6 / searchStats.elapsedUs);
+}
+
+const MCTSStats& GameAI::getLastMCTSStats() const {
+    return mcts.getLastStats();
+}
+
+const ArenaStats& GameAI::getArenaStats() const {
+    return arena.getStats();
+}
+
+PoolStats GameAI::getPoolStats() const {
+    return mcts.getPoolStats();
+}
+
 std::pair<int, int> GameAI::getBestMove(const GameBoard& board, Player player) {
+    return getScoredMove(board, player).move;
+}
+
+ScoredMove GameAI::getScoredMove(const GameBoard& board, Player player) {
+    PROFILE_ZONE("getBestMove");
     auto start = std::chrono::high_resolution_clock::now();
+    searchStats = SearchStats();
+    
+    if (verbose) {
+        std::cout << "\nAI is calculating move for " << (player == Player::BLACK ? "BLACK" : "WHITE") 
+                  << " player (Difficulty: " 
+                  << (currentDifficulty == AIDifficulty::EASY ? "EASY" : 
+                      currentDifficulty == AIDifficulty::MEDIUM ? "MEDIUM" : "HARD")
+                  << ", Engine: " << (currentEngine == AIEngine::MCTS ? "MCTS" : "MINIMAX")
+                  << ")..." << std::endl;
+    }
+    
+    ScoredMove best{{-1, -1}, 0};
+    bool won = false;
+    
+    if (trySolve(board, player, best.move, won)) {
+        best.score = won ? WIN_SCORE : 0;
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        searchStats.elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        publishSearchMetrics();
+        if (verbose) {
+            std::cout << "move(" << best.move.first << "," << best.move.second
+                      << ") (solved in " << duration.count() << "ms)" << std::endl;
+        }
+        return best;
+    }
+    
+    if (currentEngine == AIEngine::MCTS) {
+        best.move = getBestMoveMCTS(board, player);
+    } else {
+        switch (currentDifficulty) {
+            case AIDifficulty::EASY:
+                best = getBestMoveWithDepth(board, player, 1);
+                break;
+            case AIDifficulty::MEDIUM:
+                best = getBestMoveWithDepth(board, player, 3);
+                break;
+            case AIDifficulty::HARD:
+                // Selective search reaches 7 plies in less time than 5 took exhaustively.
+                best = getBestMoveWithDepth(board, player, 7);
+                break;
+        }
+    }
     
-    std::cout << "\nAI is calculating move for " << (player == Player::BLACK ? "BLACK" : "WHITE") 
-              << " player (Difficulty: " 
-              << (currentDifficulty == AIDifficulty::EASY ? "EASY" : 
-                  currentDifficulty == AIDifficulty::MEDIUM ? "MEDIUM" : "HARD")
-              << ")..." << std::endl;
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    searchStats.elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    publishSearchMetrics();
     
-    std::pair<int, int> bestMove;
+    if (verbose) {
+        std::cout << "move(" << best.move.first << "," << best.move.second 
+                  << ") (calculation took " << duration.count() << "ms, " << searchStats.nodes << " nodes, "
+                  << searchStats.tableHits << "/" << searchStats.tableProbes << " table hits)" << std::endl;
+        if (selectiveActive) {
+            std::cout << "Selective: " << searchStats.lmrReductions << " reduced (" << searchStats.lmrResearches
+                      << " re-searched), " << searchStats.lateMovesPruned << " late moves and "
+                      << searchStats.futilityPruned << " futile moves pruned" << std::endl;
+        }
+    }
     
+    return best;
+}
+
+std::pair<int, int> GameAI::getBestMoveMCTS(const GameBoard& board, Player player) {
+    uint64_t maxPlayouts = 0;
+    int maxTimeMs = 0;
     switch (currentDifficulty) {
         case AIDifficulty::EASY:
-            bestMove = getBestMoveWithDepth(board, player, 1);
+            maxPlayouts = 3000;
+            maxTimeMs = 300;
             break;
         case AIDifficulty::MEDIUM:
-            bestMove = getBestMoveWithDepth(board, player, 3);
+            maxPlayouts = 30000;
+            maxTimeMs = 2000;
             break;
         case AIDifficulty::HARD:
-            bestMove = getBestMoveWithDepth(board, player, 5);
+            maxPlayouts = 200000;
+            maxTimeMs = 5000;
             break;
     }
-    
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-    
-    std::cout << "move(" << bestMove.first << "," << bestMove.second 
-              << ") (calculation took " << duration.count() << "ms)" << std::endl;
-    
-    return bestMove;
+    if (mctsPlayoutLimit > 0) maxPlayouts = mctsPlayoutLimit;
+    if (mctsTimeLimitMs > 0) maxTimeMs = mctsTimeLimitMs;
+
+    // Time limits depend on machine load; a deterministic search only counts playouts.
+    if (deterministic) maxTimeMs = std::numeric_limits<int>::max();
+    std::pair<int, int> move = mcts.search(board, player, maxPlayouts, maxTimeMs);
+    const MCTSStats& stats = mcts.getLastStats();
+    if (verbose) {
+        std::cout << "MCTS: " << stats.playouts << " playouts (" << static_cast<int64_t>(stats.playoutsPerSecond)
+                  << " playouts/s), " << stats.nodes << " nodes, " << stats.reusedVisits
+                  << " visits reused" << std::endl;
+    }
+    return move;
 }
 
-std::pair<int, int> GameAI::getBestMoveWithDepth(const GameBoard& board, Player player, int depth) {
-    int alpha = std::numeric_limits<int>::min();
-    int beta = std::numeric_limits<int>::max();
+ScoredMove GameAI::getBestMoveWithDepth(const GameBoard& board, Player player, int depth) {
+    int alpha = -INF;
+    int beta = INF;
     
-    std::vector<std::pair<int, int>> moves = getPossibleMoves(board);
-    std::sort(moves.begin(), moves.end(), [this, &board, player](const auto& a, const auto& b) {
-        return evaluateMove(board, a.first, a.second, player) > 
-               evaluateMove(board, b.first, b.second, player);
-    });
+    selectiveActive = selective.enabled && depth >= selective.minDepth;
+
+    // One working copy per search; every node below makes and undoes moves on it.
+    arena.reset();
+    startSearch();
+    GameBoard& tempBoard = workBoard;
+    tempBoard = board;
+    evaluator->reset(tempBoard);
+    threats.reset(tempBoard);
     
-    int bestScore = std::numeric_limits<int>::min();
-    std::pair<int, int> bestMove = {-1, -1};
+    const uint64_t key = tableKey(board, player);
+    ScoredMove* moves = arena.moves(0);
+    int moveCount = orderMoves(tempBoard, player, moves);
+    if (trace) trace->beginSearch(board.getHash(), player, depth);
     
-    GameBoard* tempBoard = new GameBoard();
-    *tempBoard = board;
+    int bestScore = -INF;
+    std::pair<int, int> bestMove = {-1, -1};
+    AnalysisInfo info;
+    info.depth = depth;
+    info.totalMoves = moveCount;
     
-    for (const auto& move : moves) {
-        if (tempBoard->makeMove(move.first, move.second, player)) {
-            int score = -minimax(*tempBoard, depth - 1, -beta, -alpha, false, getOpponent(player));
-            tempBoard->undoMove();
+    for (int i = 0; i < moveCount; ++i) {
+        const auto& move = moves[i].move;
+        if (makeSearchMove(tempBoard, move.first, move.second, player)) {
+            if (trace) trace->enter(move);
+            int score = -minimax(tempBoard, depth - 1, 1, -beta, -alpha, getOpponent(player));
+            undoSearchMove(tempBoard, move.first, move.second, player);
+            // An interrupted subtree has no meaningful score.
+            if (stopRequested.load(std::memory_order_relaxed)) {
+                if (bestMove.first < 0) bestMove = move;
+                break;
+            }
             
-            std::cout << "Move (" << move.first << "," << move.second << ") score: " << score << std::endl;
+            if (verbose) std::cout << "Move (" << move.first << "," << move.second << ") score: " << score << std::endl;
             
             if (score > bestScore) {
                 bestScore = score;
                 bestMove = move;
+                if (progress) {
+                    info.bestMoves.assign(1, ScoredMove{move, score});
+                    info.pv.assign(1, move);
+                    info.pv.insert(info.pv.end(), pvMoves[1], pvMoves[1] + pvLength[1]);
+                    info.pvs.assign(1, info.pv);
+                }
+            }
+            if (progress) {
+                info.searchedMoves++;
+                info.rootMoves.push_back(ScoredMove{move, score});
+                progress(info);
             }
             
             alpha = std::max(alpha, score);
@@ -83,164 +404,373 @@ std::pair<int, int> GameAI::getBestMoveWithDepth(const GameBoard& board, Player
         }
     }
     
-    delete tempBoard;
-    return bestMove;
-}
-
-std::pair<int, int> GameAI::getRandomMove(const GameBoard& board) {
-    std::vector<std::pair<int, int>> moves = getPossibleMoves(board);
-    if (moves.empty()) {
-        return {-1, -1};
+    if (bestMove.first >= 0 && !stopRequested.load(std::memory_order_relaxed)) {
+        table.store(key, toTableScore(bestScore, 0), depth, TranspositionTable::EXACT,
+                    bestMove.first * GameBoard::BOARD_SIZE + bestMove.second);
     }
-    
-    std::uniform_int_distribution<size_t> dist(0, moves.size() - 1);
-    return moves[dist(rng)];
+    if (trace) trace->endSearch(bestMove, bestScore == -INF ? 0 : bestScore);
+    return ScoredMove{bestMove, bestScore == -INF ? 0 : bestScore};
 }
 
-int GameAI::minimax(const GameBoard& board, int depth, int alpha, int beta, bool maximizing, Player player) {
-    if (depth == 0 || board.getGameState() != GameState::IN_PROGRESS) {
-        return evaluateBoard(board, player);
-    }
+AnalysisInfo GameAI::analyze(const GameBoard& board, Player player, int maxDepth, int topMoves,
+                             const AnalysisCallback& callback) {
+    AnalysisInfo info;
+    searchStats = SearchStats();
+    if (board.getGameState() != GameState::IN_PROGRESS || topMoves < 1) return info;
     
-    std::vector<std::pair<int, int>> moves = getPossibleMoves(board);
-    std::sort(moves.begin(), moves.end(), [this, &board, player](const auto& a, const auto& b) {
-        return evaluateMove(board, a.first, a.second, player) > 
-               evaluateMove(board, b.first, b.second, player);
-    });
+    auto start = std::chrono::steady_clock::now();
+    auto finish = [&]() {
+        searchStats.elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        publishSearchMetrics();
+        return info;
+    };
+    arena.reset();
+    startSearch();
+    GameBoard& tempBoard = workBoard;
+    tempBoard = board;
+    evaluator->reset(tempBoard);
+    threats.reset(tempBoard);
     
-    GameBoard* tempBoard = new GameBoard();
-    *tempBoard = board;
+    ScoredMove* moves = arena.moves(0);
+    selectiveActive = false;
+    int moveCount = orderMoves(tempBoard, player, moves);
+    info.totalMoves = moveCount;
     
-    if (maximizing) {
-        int maxScore = std::numeric_limits<int>::min();
-        for (const auto& move : moves) {
-            if (tempBoard->makeMove(move.first, move.second, player)) {
-                int score = minimax(*tempBoard, depth - 1, alpha, beta, false, getOpponent(player));
-                tempBoard->undoMove();
-                maxScore = std::max(maxScore, score);
-                alpha = std::max(alpha, score);
-                if (alpha >= beta) {
-                    delete tempBoard;
-                    return maxScore;
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        selectiveActive = selective.enabled && depth >= selective.minDepth;
+        AnalysisInfo current;
+        current.depth = depth;
+        current.totalMoves = moveCount;
+        if (trace) trace->beginSearch(board.getHash(), player, depth);
+        
+        for (int i = 0; i < moveCount; ++i) {
+            // Until the list is full every move gets an exact window. After
+            // that a move only needs an exact score if it beats the N-th
+            // best, which a null window around that score shows; the few that
+            // do are searched again above it.
+            bool full = static_cast<int>(current.bestMoves.size()) >= topMoves;
+            int alpha = full ? current.bestMoves.back().score : -INF;
+            const auto& move = moves[i].move;
+            makeSearchMove(tempBoard, move.first, move.second, player);
+            if (trace) trace->enter(move);
+            int score;
+            if (full) {
+                score = -minimax(tempBoard, depth - 1, 1, -alpha - 1, -alpha, getOpponent(player));
+                if (score > alpha && !stopRequested.load(std::memory_order_relaxed)) {
+                    searchStats.rootResearches++;
+                    if (trace) trace->enter(move);
+                    score = -minimax(tempBoard, depth - 1, 1, -INF, -alpha, getOpponent(player));
                 }
+            } else {
+                score = -minimax(tempBoard, depth - 1, 1, -INF, INF, getOpponent(player));
             }
-        }
-        delete tempBoard;
-        return maxScore;
-    } else {
-        int minScore = std::numeric_limits<int>::max();
-        for (const auto& move : moves) {
-            if (tempBoard->makeMove(move.first, move.second, player)) {
-                int score = minimax(*tempBoard, depth - 1, alpha, beta, true, getOpponent(player));
-                tempBoard->undoMove();
-                minScore = std::min(minScore, score);
-                beta = std::min(beta, score);
-                if (alpha >= beta) {
-                    delete tempBoard;
-                    return minScore; // Alpha cutoff
+            undoSearchMove(tempBoard, move.first, move.second, player);
+            if (stopRequested.load(std::memory_order_relaxed)) return finish();
+            
+            moves[i].score = score;
+            current.searchedMoves++;
+            current.rootMoves.push_back(ScoredMove{move, score});
+            if (!full || score > alpha) {
+                // Equal scores go after the moves already listed, so ties
+                // rank in root order, which orderMoves() fully defines.
+                auto position = std::upper_bound(current.bestMoves.begin(), current.bestMoves.end(), score,
+                                                 [](int value, const ScoredMove& entry) { return value > entry.score; });
+                std::vector<std::pair<int, int>> line(1, move);
+                line.insert(line.end(), pvMoves[1], pvMoves[1] + pvLength[1]);
+                current.pvs.insert(current.pvs.begin() + (position - current.bestMoves.begin()), std::move(line));
+                current.bestMoves.insert(position, ScoredMove{move, score});
+                if (full) {
+                    current.bestMoves.pop_back();
+                    current.pvs.pop_back();
                 }
+                current.pv = current.pvs.front();
             }
+            if (callback) callback(current);
         }
-        delete tempBoard;
-        return minScore;
+        
+        info = current;
+        if (trace) trace->endSearch(info.bestMoves.front().move, info.bestMoves.front().score);
+        // This depth's scores order the next one.
+        std::stable_sort(moves, moves + moveCount, [](const ScoredMove& a, const ScoredMove& b) {
+            return a.score > b.score;
+        });
+        if (info.bestMoves.front().score >= WIN_SCORE - depth) break;
     }
+    
+    return finish();
 }
 
-int GameAI::evaluateBoard(const GameBoard& board, Player player) {
-    int score = 0;
-    Player opponent = getOpponent(player);
+bool GameAI::trySolve(const GameBoard& board, Player player, std::pair<int, int>& move, bool& won) {
+    if (!ProofSolver::isEndgame(board)) return false;
+
+    SolverResult solved = solver.solve(board, player);
+    searchStats.solverNodes = solved.nodes;
+    searchStats.solverTableProbes = solved.tableProbes;
+    searchStats.solverTableHits = solved.tableHits;
+    if (verbose) {
+        std::cout << "Endgame solver: "
+                  << (solved.result == ProofResult::WIN ? "WIN" :
+                      solved.result == ProofResult::LOSS ? "LOSS" :
+                      solved.result == ProofResult::DRAW ? "DRAW" : "UNKNOWN")
+                  << " after " << solved.nodes << " nodes" << std::endl;
+    }
+
+    // A proven loss has no best move, so the heuristic search picks the most stubborn one.
+    if (solved.result != ProofResult::WIN && solved.result != ProofResult::DRAW) return false;
+    if (!board.isValidMove(solved.bestMove.first, solved.bestMove.second)) return false;
+
+    move = solved.bestMove;
+    won = solved.result == ProofResult::WIN;
+    return true;
+}
+
+std::pair<int, int> GameAI::getRandomMove(const GameBoard& board) {
+    ScoredMove* moves = arena.moves(0);
+    int moveCount = getPossibleMoves(board, moves);
+    if (moveCount == 0) {
+        return {-1, -1};
+    }
     
-    int centerX = GameBoard::BOARD_SIZE / 2;
-    int centerY = GameBoard::BOARD_SIZE / 2;
-    for (int i = -2; i <= 2; i++) {
-        for (int j = -2; j <= 2; j++) {
-            int x = centerX + i;
-            int y = centerY + j;
-            if (x >= 0 && x < GameBoard::BOARD_SIZE && y >= 0 && y < GameBoard::BOARD_SIZE) {
-                if (board.getCell(x, y) == player) {
-                    score += (3 - std::max(std::abs(i), std::abs(j))) * 10;
-                }
+    std::uniform_int_distribution<int> dist(0, moveCount - 1);
+    return moves[dist(rng)].move;
+}
+
+bool GameAI::makeSearchMove(GameBoard& board, int row, int col, Player player) {
+    if (!board.makeMove(row, col, player)) return false;
+    // The child probes the table first thing; start fetching its bucket
+    // while the evaluators update.
+    table.prefetch(tableKey(board, getOpponent(player)));
+    evaluator->onMakeMove(row, col, player);
+    threats.onMakeMove(row, col, player);
+    return true;
+}
+
+void GameAI::undoSearchMove(GameBoard& board, int row, int col, Player player) {
+    board.undoMove();
+    evaluator->onUndoMove(row, col, player);
+    threats.onUndoMove(row, col, player);
+}
+
+// Negamax: scores are from the point of view of `player`, the side to move.
+int GameAI::minimax(GameBoard& board, int depth, int ply, int alpha, int beta, Player player) {
+    PROFILE_ZONE("minimax");
+    searchStats.nodes++;
+    if (ply < MAX_PV) pvLength[ply] = 0;
+    GameState state = board.getGameState();
+    if (state != GameState::IN_PROGRESS) {
+        // The side that just moved made six; sooner wins score higher.
+        int score = state == GameState::DRAW ? 0 : -(WIN_SCORE - ply);
+        if (trace) trace->exit(SearchTrace::NodeKind::TERMINAL, score);
+        return score;
+    }
+    if (depth == 0) {
+        if (quiescenceDepth > 0) return quiescence(board, quiescenceDepth, ply, alpha, beta, player);
+        int score = evaluateBoard(board, player);
+        if (trace) trace->exit(SearchTrace::NodeKind::LEAF, score);
+        return score;
+    }
+    if (stopRequested.load(std::memory_order_relaxed)) {
+        if (trace) trace->exit(SearchTrace::NodeKind::STOPPED, 0);
+        return 0;
+    }
+    if (selectiveActive) {
+        // Mate distance: nothing here can beat winning with the next move or
+        // lose sooner than now, so a window outside that range is already decided.
+        alpha = std::max(alpha, -(WIN_SCORE - ply));
+        beta = std::min(beta, WIN_SCORE - ply - 1);
+        if (alpha >= beta) {
+            if (trace) trace->exit(SearchTrace::NodeKind::CUTOFF, alpha);
+            return alpha;
+        }
+    }
+
+    const int originalAlpha = alpha;
+    const uint64_t key = tableKey(board, player);
+    TranspositionTable::Entry entry;
+    int tableMove = -1;
+    searchStats.tableProbes++;
+    if (table.probe(key, entry)) {
+        searchStats.tableHits++;
+        tableMove = entry.move;
+        int score = fromTableScore(entry.score, ply);
+        if (entry.depth >= depth
+            && (entry.bound == TranspositionTable::EXACT
+                || (entry.bound == TranspositionTable::LOWER && score >= beta)
+                || (entry.bound == TranspositionTable::UPPER && score <= alpha))) {
+            if (entry.bound == TranspositionTable::EXACT && tableMove >= 0 && ply < MAX_PV) {
+                pvMoves[ply][0] = {tableMove / GameBoard::BOARD_SIZE, tableMove % GameBoard::BOARD_SIZE};
+                pvLength[ply] = 1;
             }
+            if (trace) trace->exit(SearchTrace::NodeKind::TABLE, score);
+            return score;
         }
     }
     
-    for (int i = 0; i < GameBoard::BOARD_SIZE; ++i) {
-        for (int j = 0; j < GameBoard::BOARD_SIZE; ++j) {
-            if (board.getCell(i, j) == player) {
-                for (int di = -1; di <= 1; ++di) {
-                    for (int dj = -1; dj <= 1; ++dj) {
-                        if (di == 0 && dj == 0) continue;
-                        
-                        score += evaluatePattern(board, i, j, di, dj, player);
-                        score -= evaluatePattern(board, i, j, di, dj, opponent) * 2;
-                    }
+    // The table move is searched before the other moves are even scored:
+    // when it cuts off, as it mostly does, the node skips move ordering.
+    ScoredMove* moves = arena.moves(ply);
+    int moveCount;
+    bool generated = false;
+    if (tableMove >= 0
+        && board.getCell(tableMove / GameBoard::BOARD_SIZE, tableMove % GameBoard::BOARD_SIZE) == Player::NONE) {
+        moves[0] = ScoredMove{{tableMove / GameBoard::BOARD_SIZE, tableMove % GameBoard::BOARD_SIZE}, TABLE_MOVE_SCORE};
+        moveCount = 1;
+    } else {
+        moveCount = orderMoves(board, player, moves, tableMove, true);
+        generated = true;
+    }
+
+    // Forcing moves sort first, so once one quiet move may be pruned all the
+    // moves after it may be too.
+    const bool futile = selectiveActive && depth == 1
+        && evaluateBoard(board, player) + selective.futilityMargin <= alpha;
+    const int quietLimit = selective.lmpBaseMoves + selective.lmpMovesPerDepth * depth;
+    int quietMoves = 0;
+    
+    int bestScore = -INF;
+    int bestMove = -1;
+    for (int i = 0; i < moveCount; ++i) {
+        const auto& move = moves[i].move;
+        const bool quiet = selectiveActive && i > 0 && moves[i].score < FORCING_BONUS;
+        if (quiet && futile) {
+            searchStats.futilityPruned += moveCount - i;
+            break;
+        }
+        if (quiet && quietMoves >= quietLimit) {
+            searchStats.lateMovesPruned += moveCount - i;
+            break;
+        }
+        if (makeSearchMove(board, move.first, move.second, player)) {
+            if (trace) trace->enter(move);
+            int score;
+            if (quiet && depth >= selective.lmrMinDepth && quietMoves >= selective.lmrFullDepthMoves) {
+                searchStats.lmrReductions++;
+                int reducedDepth = std::max(0, depth - 1 - selective.lmrReduction);
+                score = -minimax(board, reducedDepth, ply + 1, -alpha - 1, -alpha, getOpponent(player));
+                if (score > alpha) {
+                    searchStats.lmrResearches++;
+                    if (trace) trace->enter(move);
+                    score = -minimax(board, depth - 1, ply + 1, -beta, -alpha, getOpponent(player));
                 }
+            } else {
+                score = -minimax(board, depth - 1, ply + 1, -beta, -alpha, getOpponent(player));
+            }
+            undoSearchMove(board, move.first, move.second, player);
+            if (quiet) quietMoves++;
+            bestScore = std::max(bestScore, score);
+            if (score > alpha) {
+                alpha = score;
+                bestMove = move.first * GameBoard::BOARD_SIZE + move.second;
+                recordPV(ply, move);
+            }
+            if (alpha >= beta) {
+                history[player == Player::BLACK ? 0 : 1][bestMove] += depth * depth;
+                break;
             }
         }
+        if (!generated) {
+            // orderMoves puts the table move first again, so the loop goes on at the second move.
+            moveCount = orderMoves(board, player, moves, tableMove, true);
+            generated = true;
+        }
     }
-    
-    return score;
+    // An interrupted subtree's score is meaningless and must not be kept.
+    if (bestScore != -INF && !stopRequested.load(std::memory_order_relaxed)) {
+        TranspositionTable::Bound bound = bestScore <= originalAlpha ? TranspositionTable::UPPER
+            : bestScore >= beta ? TranspositionTable::LOWER : TranspositionTable::EXACT;
+        table.store(key, toTableScore(bestScore, ply), depth, bound, bestMove);
+    }
+    if (trace) trace->exit(alpha >= beta ? SearchTrace::NodeKind::CUTOFF : SearchTrace::NodeKind::INTERIOR, bestScore);
+    return bestScore;
 }
 
-int GameAI::evaluatePattern(const GameBoard& board, int row, int col, int dRow, int dCol, Player player) {
-    int count = 1;
-    int openEnds = 0;
-    int spaces = 0;
-    
-    int r = row + dRow;
-    int c = col + dCol;
-    bool blocked = false;
-    
-    while (r >= 0 && r < GameBoard::BOARD_SIZE && c >= 0 && c < GameBoard::BOARD_SIZE && spaces <= 2) {
-        if (board.getCell(r, c) == player) {
-            if (spaces == 0) count++;
-            else break;
-        } else if (board.getCell(r, c) == Player::NONE) {
-            spaces++;
-            if (spaces == 1) openEnds++;
-        } else {
-            blocked = true;
-            break;
+// Search past the horizon, so a leaf is never scored in the middle of a
+// tactic: the side to move wins if it has a five, must block the opponent's
+// five, and loses to two. Otherwise the static evaluation stands unless
+// turning one of its fours into a five, which forces the reply, does better.
+int GameAI::quiescence(GameBoard& board, int depth, int ply, int alpha, int beta, Player player) {
+    if (ply < MAX_PV) pvLength[ply] = 0;
+    GameState state = board.getGameState();
+    if (state != GameState::IN_PROGRESS) {
+        int score = state == GameState::DRAW ? 0 : -(WIN_SCORE - ply);
+        if (trace) trace->exit(SearchTrace::NodeKind::TERMINAL, score);
+        return score;
+    }
+
+    ScoredMove* moves = arena.moves(ply);
+    if (threats.getWinningCells(player, moves) > 0) {
+        if (ply + 1 < MAX_PV) pvLength[ply + 1] = 0;
+        recordPV(ply, moves[0].move);
+        int score = WIN_SCORE - ply - 1;
+        if (trace) trace->exit(SearchTrace::NodeKind::LEAF, score);
+        return score;
+    }
+    Player opponent = getOpponent(player);
+    int fives = threats.getWinningCells(opponent, moves);
+    if (fives >= 2) {
+        // Only one of them can be blocked.
+        int score = -(WIN_SCORE - ply - 2);
+        if (trace) trace->exit(SearchTrace::NodeKind::LEAF, score);
+        return score;
+    }
+    if (depth == 0 || stopRequested.load(std::memory_order_relaxed)) {
+        int score = evaluateBoard(board, player);
+        if (trace) trace->exit(SearchTrace::NodeKind::LEAF, score);
+        return score;
+    }
+
+    int bestScore = -INF;
+    int moveCount = 1;
+    if (fives == 0) {
+        // Standing pat: the side to move need not start a threat.
+        bestScore = evaluateBoard(board, player);
+        if (bestScore >= beta) {
+            if (trace) trace->exit(SearchTrace::NodeKind::LEAF, bestScore);
+            return bestScore;
         }
-        r += dRow;
-        c += dCol;
+        alpha = std::max(alpha, bestScore);
+        moveCount = threats.getThreatMoves(player, moves);
     }
-    spaces = 0;
-    
-    r = row - dRow;
-    c = col - dCol;
-    
-    while (r >= 0 && r < GameBoard::BOARD_SIZE && c >= 0 && c < GameBoard::BOARD_SIZE && spaces <= 2) {
-        if (board.getCell(r, c) == player) {
-            if (spaces == 0) count++;
-            else break;
-        } else if (board.getCell(r, c) == Player::NONE) {
-            spaces++;
-            if (spaces == 1) openEnds++;
-        } else {
-            blocked = true;
-            break;
+    for (int i = 0; i < moveCount; ++i) {
+        const auto move = moves[i].move;
+        if (!makeSearchMove(board, move.first, move.second, player)) continue;
+        if (trace) trace->enter(move);
+        searchStats.nodes++;
+        searchStats.quiescenceNodes++;
+        int score = -quiescence(board, depth - 1, ply + 1, -beta, -alpha, opponent);
+        undoSearchMove(board, move.first, move.second, player);
+        bestScore = std::max(bestScore, score);
+        if (score > alpha) {
+            alpha = score;
+            recordPV(ply, move);
         }
-        r -= dRow;
-        c -= dCol;
+        if (alpha >= beta) break;
     }
-    
-    int score = 0;
-    if (count >= 6) return 100000;
-    if (count == 5 && openEnds > 0) score = 50000;
-    else if (count == 4 && openEnds == 2) score = 10000;
-    else if (count == 4 && openEnds == 1) score = 5000;
-    else if (count == 3 && openEnds == 2) score = 1000;
-    else if (count == 3 && openEnds == 1) score = 500;
-    else if (count == 2 && openEnds == 2) score = 100;
-    else if (count == 2 && openEnds == 1) score = 50;
-    
-    if (blocked) score /= 2;
-    
-    return score;
+    if (trace) trace->exit(alpha >= beta ? SearchTrace::NodeKind::CUTOFF : SearchTrace::NodeKind::INTERIOR, bestScore);
+    return bestScore;
+}
+
+void GameAI::recordPV(int ply, const std::pair<int, int>& move) {
+    if (ply >= MAX_PV) return;
+    pvMoves[ply][0] = move;
+    int childLength = (ply + 1 < MAX_PV) ? std::min(pvLength[ply + 1], MAX_PV - 1) : 0;
+    if (childLength > 0) std::copy(pvMoves[ply + 1], pvMoves[ply + 1] + childLength, pvMoves[ply] + 1);
+    pvLength[ply] = childLength + 1;
+}
+
+int GameAI::evaluateBoard(const GameBoard& board, Player player) {
+    PROFILE_ZONE("evaluateBoard");
+    return evaluator->evaluate(board, player);
 }
 
-int GameAI::evaluateMove(const GameBoard& board, int row, int col, Player player) {
+int GameAI::evaluatePattern(const GameBoard& board, int row, int col, int dRow, int dCol, Player player,
+                            int* pattern) {
+    return patterns.evaluatePattern(board, row, col, dRow, dCol, player, pattern);
+}
+
+int GameAI::evaluateMove(const GameBoard& board, int row, int col, Player player, bool* forcing) {
+    PROFILE_DETAIL_ZONE("evaluateMove");
     if (board.getCell(row, col) != Player::NONE) return std::numeric_limits<int>::min();
     
     int score = 0;
@@ -250,37 +780,67 @@ int GameAI::evaluateMove(const GameBoard& board, int row, int col, Player player
     int distanceFromCenter = std::max(std::abs(row - centerX), std::abs(col - centerY));
     score += (GameBoard::BOARD_SIZE / 2 - distanceFromCenter) * 10;
     
+    // evaluatePattern only reads the cells around (row, col), so the stone
+    // does not need to be placed on a copy of the board first.
+    Player opponent = getOpponent(player);
+    int strongest = PatternWeights::PATTERN_COUNT;
     for (int dRow = -1; dRow <= 1; ++dRow) {
         for (int dCol = -1; dCol <= 1; ++dCol) {
             if (dRow == 0 && dCol == 0) continue;
             
-            GameBoard* tempBoard = new GameBoard();
-            *tempBoard = board;
-            tempBoard->makeMove(row, col, player);
-            score += evaluatePattern(*tempBoard, row, col, dRow, dCol, player);
-            
-            Player opponent = getOpponent(player);
-            score += evaluatePattern(*tempBoard, row, col, dRow, dCol, opponent) / 2;
-            
-            delete tempBoard;
+            int own, theirs;
+            score += evaluatePattern(board, row, col, dRow, dCol, player, &own);
+            score += evaluatePattern(board, row, col, dRow, dCol, opponent, &theirs) / 2;
+            strongest = std::min(strongest, std::min(own, theirs));
         }
     }
+    if (forcing) *forcing = strongest <= PatternWeights::OPEN_FOUR;
     
     return score;
 }
 
-std::vector<std::pair<int, int>> GameAI::getPossibleMoves(const GameBoard& board) {
-    std::vector<std::pair<int, int>> moves;
+int GameAI::getPossibleMoves(const GameBoard& board, ScoredMove* moves) {
+    int count = 0;
     
     for (int i = 0; i < GameBoard::BOARD_SIZE; ++i) {
         for (int j = 0; j < GameBoard::BOARD_SIZE; ++j) {
             if (board.getCell(i, j) == Player::NONE) {
-                moves.emplace_back(i, j);
+                moves[count++] = ScoredMove{{i, j}, 0};
             }
         }
     }
     
-    return moves;
+    return count;
+}
+
+int GameAI::orderMoves(const GameBoard& board, Player player, ScoredMove* moves, int tableMove, bool historyBonus) {
+    int count = getPossibleMoves(board, moves);
+    const uint32_t* ranks = history[player == Player::BLACK ? 0 : 1];
+    for (int i = 0; i < count; ++i) {
+        const auto& move = moves[i].move;
+        if (move.first * GameBoard::BOARD_SIZE + move.second == tableMove) {
+            moves[i].score = TABLE_MOVE_SCORE;
+            continue;
+        }
+        bool forcing;
+        moves[i].score = evaluateMove(board, move.first, move.second, player, &forcing);
+        if (forcing && selectiveActive) moves[i].score += FORCING_BONUS;
+        if (historyBonus) {
+            uint32_t rank = ranks[move.first * GameBoard::BOARD_SIZE + move.second];
+            moves[i].score += HISTORY_WEIGHT * static_cast<int>(rank < HISTORY_CAP ? rank : HISTORY_CAP);
+        }
+    }
+    // Ties break on the history table, then on the cell, so the order is fully
+    // defined and the same with every standard library (std::sort alone leaves
+    // equal scores unordered).
+    std::sort(moves, moves + count, [ranks](const ScoredMove& a, const ScoredMove& b) {
+        if (a.score != b.score) return a.score > b.score;
+        uint32_t rankA = ranks[a.move.first * GameBoard::BOARD_SIZE + a.move.second];
+        uint32_t rankB = ranks[b.move.first * GameBoard::BOARD_SIZE + b.move.second];
+        if (rankA != rankB) return rankA > rankB;
+        return a.move < b.move;
+    });
+    return count;
 }
 
 Player GameAI::getOpponent(Player player) {
@@ -0,0 +1,90 @@
+#include "ai/HintService.h"
+#include "core/Metrics.h"
+#include "core/Profiler.h"
+
+HintService::HintService(int topMoves, int maxDepth)
+    : topMoves(topMoves)
+    , maxDepth(maxDepth)
+    , channel(nullptr)
+    , positionHash(0)
+    , analyzing(false) {
+    ai.setVerbose(false);
+}
+
+HintService::~HintService() {
+    stop();
+}
+
+void HintService::analyze(const GameBoard& board) {
+    if (analyzing && board.getHash() == positionHash && board.getMoveCount() == position.getMoveCount()) return;
+
+    stop();
+    if (channel) channel->clear();
+    if (board.getGameState() != GameState::IN_PROGRESS) return;
+
+    position = board;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        positionHash = board.getHash();
+        cached = Hint();
+    }
+    analyzing = true;
+    worker = std::thread(&HintService::run, this);
+}
+
+void HintService::stop() {
+    if (worker.joinable()) {
+        ai.requestStop();
+        worker.join();
+        ai.clearStopRequest();
+    }
+    analyzing = false;
+}
+
+void HintService::setChannel(AnalysisChannel* value) {
+    channel = value;
+}
+
+bool HintService::getHint(const GameBoard& board, Hint& hint, std::chrono::milliseconds wait) const {
+    static MetricCounter& hits = MetricsRegistry::global().counter(
+        "connect6_hint_hits_total", "Hints answered from the background analysis");
+    static MetricCounter& misses = MetricsRegistry::global().counter(
+        "connect6_hint_misses_total", "Hints the background analysis could not answer");
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!analyzing || board.getHash() != positionHash
+        || !updated.wait_for(lock, wait, [this]() { return !cached.moves.empty(); })) {
+        misses.add();
+        return false;
+    }
+    hint = cached;
+    hits.add();
+    return true;
+}
+
+void HintService::run() {
+    Profiler::setThreadName("hints");
+    AnalysisInfo info = ai.analyze(position, position.getCurrentPlayer(), maxDepth, topMoves,
+                                   [this](const AnalysisInfo& progress) { update(progress); });
+    if (ai.isStopRequested()) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    cached.moves = info.bestMoves;
+    cached.depth = info.depth;
+    cached.final = true;
+    updated.notify_all();
+}
+
+void HintService::update(const AnalysisInfo& info) {
+    // A finished depth is kept until the next one finishes; before the first
+    // one finishes the partial list is the best there is.
+    if (channel) channel->publish(info);
+    
+    bool complete = info.searchedMoves == info.totalMoves;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (complete || cached.depth == 0) {
+        cached.moves = info.bestMoves;
+        cached.depth = complete ? info.depth : 0;
+        updated.notify_all();
+    }
+}
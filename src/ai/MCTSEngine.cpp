@@ -0,0 +1,327 @@
+#include "ai/MCTSEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const uint8_t UNEXPANDED = 0;
+const uint8_t EXPANDING = 1;
+const uint8_t EXPANDED = 2;
+const int DRAW = 2;
+const double EXPLORATION = 0.7;
+// Leaves are expanded only after this many playouts, which keeps the pool
+// from filling up with children that are never revisited.
+const int32_t EXPANSION_VISITS = 8;
+
+uint64_t nextRandom(uint64_t& state) {
+    // xorshift64*: plenty for playouts and far cheaper than std::mt19937
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+} // namespace
+
+struct MCTSEngine::Node {
+    std::atomic<int32_t> visits;
+    std::atomic<int32_t> score;         // 2 per win, 1 per draw, for the player who moved into this node
+    std::atomic<int32_t> virtualLoss;
+    std::atomic<uint8_t> state;
+    int32_t firstChild;
+    int16_t childCount;
+    int16_t move;
+
+    void init(int16_t cell) {
+        visits.store(0, std::memory_order_relaxed);
+        score.store(0, std::memory_order_relaxed);
+        virtualLoss.store(0, std::memory_order_relaxed);
+        state.store(UNEXPANDED, std::memory_order_relaxed);
+        firstChild = -1;
+        childCount = 0;
+        move = cell;
+    }
+};
+
+void MCTSEngine::Position::play(int index) {
+    stones[toMove].set(index);
+    empty.clear(index);
+    if (BitBoard::makesLine(stones[toMove], index)) {
+        winner = toMove;
+    } else if (empty.isEmpty()) {
+        winner = DRAW;
+    }
+    candidates |= BitBoard::neighborhood(index);
+    candidates &= empty;
+    toMove ^= 1;
+}
+
+MCTSEngine::MCTSEngine(size_t nodeCapacity)
+    : nodes(new NodePool<Node>(nodeCapacity))
+    , playouts(0)
+    , root(-1)
+    , threadCount(std::max(1u, std::thread::hardware_concurrency()))
+    , stopFlag(nullptr)
+    , seed(0x853C49E6748FEA9BULL) {
+}
+
+MCTSEngine::~MCTSEngine() = default;
+
+void MCTSEngine::setThreadCount(int threads) {
+    threadCount = std::max(1, threads);
+}
+
+void MCTSEngine::setSeed(uint64_t value) {
+    seed = value;
+}
+
+void MCTSEngine::setStopFlag(const std::atomic<bool>* flag) {
+    stopFlag = flag;
+}
+
+void MCTSEngine::reset() {
+    root = -1;
+    nodes->reset();
+}
+
+const MCTSStats& MCTSEngine::getLastStats() const {
+    return lastStats;
+}
+
+PoolStats MCTSEngine::getPoolStats() const {
+    return nodes->getStats();
+}
+
+std::pair<int, int> MCTSEngine::search(const GameBoard& board, Player player, uint64_t maxPlayouts, int maxTimeMs) {
+    auto start = std::chrono::steady_clock::now();
+    lastStats = MCTSStats();
+
+    Position position = toPosition(board, player);
+    if (position.empty.isEmpty() || board.getGameState() != GameState::IN_PROGRESS) {
+        return {-1, -1};
+    }
+
+    NodePool<Node>& pool = *nodes;
+    if (reuseTree(position)) {
+        lastStats.reusedVisits = pool[root].visits.load();
+    } else {
+        pool.reset();
+        root = static_cast<int32_t>(pool.allocate(1));
+        pool[root].init(-1);
+        rootPosition = position;
+    }
+    expand(pool[root], rootPosition);
+
+    Node& rootNode = pool[root];
+    if (rootNode.state.load() != EXPANDED || rootNode.childCount == 0) return {-1, -1};
+
+    // A forced move (immediate win or the only block) needs no search.
+    playouts = 0;
+    if (rootNode.childCount > 1) {
+        auto deadline = start + std::chrono::milliseconds(maxTimeMs);
+        std::vector<std::thread> workers;
+        for (int i = 1; i < threadCount; ++i) {
+            workers.emplace_back(&MCTSEngine::worker, this, i, maxPlayouts, deadline);
+        }
+        worker(0, maxPlayouts, deadline);
+        for (auto& thread : workers) thread.join();
+    }
+
+    const Node* children = &pool[rootNode.firstChild];
+    int best = 0;
+    for (int i = 1; i < rootNode.childCount; ++i) {
+        int32_t visits = children[i].visits.load();
+        int32_t bestVisits = children[best].visits.load();
+        if (visits > bestVisits || (visits == bestVisits && children[i].score.load() > children[best].score.load())) {
+            best = i;
+        }
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    lastStats.playouts = playouts.load();
+    lastStats.nodes = pool.size();
+    lastStats.elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    lastStats.playoutsPerSecond = seconds > 0 ? lastStats.playouts / seconds : 0.0;
+
+    int move = children[best].move;
+    return {BitBoard::row(move), BitBoard::col(move)};
+}
+
+void MCTSEngine::worker(int threadId, uint64_t maxPlayouts, std::chrono::steady_clock::time_point deadline) {
+    uint64_t rng = seed ^ (0x9E3779B97F4A7C15ULL * (threadId + 1));
+    NodePool<Node>& pool = *nodes;
+    int32_t path[GameBoard::BOARD_SIZE * GameBoard::BOARD_SIZE + 1];
+    size_t pathLength = 0;
+
+    for (uint64_t iteration = 0; playouts.load(std::memory_order_relaxed) < maxPlayouts; ++iteration) {
+        if ((iteration & 63) == 0 && std::chrono::steady_clock::now() >= deadline) break;
+        if (stopFlag && stopFlag->load(std::memory_order_relaxed)) break;
+
+        Position position = rootPosition;
+        Node* node = &pool[root];
+        pathLength = 0;
+        path[pathLength++] = root;
+        node->virtualLoss.fetch_add(1, std::memory_order_relaxed);
+
+        while (position.winner < 0 && node->state.load(std::memory_order_acquire) == EXPANDED) {
+            node = selectChild(*node);
+            position.play(node->move);
+            path[pathLength++] = static_cast<int32_t>(pool.indexOf(node));
+            node->virtualLoss.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (position.winner < 0 && node->visits.load(std::memory_order_relaxed) >= EXPANSION_VISITS && expand(*node, position)) {
+            node = selectChild(*node);
+            position.play(node->move);
+            path[pathLength++] = static_cast<int32_t>(pool.indexOf(node));
+            node->virtualLoss.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        int winner = position.winner >= 0 ? position.winner : runPlayout(position, rng);
+
+        for (size_t depth = 0; depth < pathLength; ++depth) {
+            Node& visited = pool[path[depth]];
+            int mover = rootPosition.toMove ^ ((depth & 1) ? 0 : 1);
+            int reward = (winner == DRAW) ? 1 : (winner == mover ? 2 : 0);
+            visited.score.fetch_add(reward, std::memory_order_relaxed);
+            visited.visits.fetch_add(1, std::memory_order_relaxed);
+            visited.virtualLoss.fetch_sub(1, std::memory_order_relaxed);
+        }
+        playouts.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+int MCTSEngine::runPlayout(Position position, uint64_t& rng) const {
+    while (position.winner < 0) {
+        const BitBoard& moves = position.candidates.isEmpty() ? position.empty : position.candidates;
+        int count = moves.count();
+        position.play(moves.nthSetBit(static_cast<int>(nextRandom(rng) % count)));
+    }
+    return position.winner;
+}
+
+bool MCTSEngine::expand(Node& node, const Position& position) {
+    uint8_t expected = UNEXPANDED;
+    if (!node.state.compare_exchange_strong(expected, EXPANDING, std::memory_order_acquire)) return false;
+
+    const BitBoard& candidates = position.candidates.isEmpty() ? position.empty : position.candidates;
+    const int opponent = position.toMove ^ 1;
+    int16_t moves[BitBoard::CELLS];
+    int count = 0;
+    int16_t blocks[BitBoard::CELLS];
+    int blockCount = 0;
+    int16_t win = -1;
+
+    if (position.stones[0].isEmpty() && position.stones[1].isEmpty()) {
+        moves[count++] = static_cast<int16_t>(BitBoard::index(GameBoard::BOARD_SIZE / 2, GameBoard::BOARD_SIZE / 2));
+    } else {
+        for (int16_t cell = 0; cell < BitBoard::CELLS && win < 0; ++cell) {
+            if (!candidates.test(cell)) continue;
+            if (BitBoard::makesLine(position.stones[position.toMove], cell)) win = cell;
+            else if (BitBoard::makesLine(position.stones[opponent], cell)) blocks[blockCount++] = cell;
+            moves[count++] = cell;
+        }
+    }
+
+    // Decisive and anti-decisive moves: take a win at once, otherwise only
+    // consider blocking an opponent's win.
+    const int16_t* children = moves;
+    if (win >= 0) {
+        children = &win;
+        count = 1;
+    } else if (blockCount > 0) {
+        children = blocks;
+        count = blockCount;
+    }
+
+    NodePool<Node>& pool = *nodes;
+    int64_t first = pool.allocate(count);
+    if (first < 0) {
+        node.state.store(UNEXPANDED, std::memory_order_release);
+        return false;
+    }
+    for (int i = 0; i < count; ++i) pool[first + i].init(children[i]);
+    node.firstChild = static_cast<int32_t>(first);
+    node.childCount = static_cast<int16_t>(count);
+    node.state.store(EXPANDED, std::memory_order_release);
+    return true;
+}
+
+MCTSEngine::Node* MCTSEngine::selectChild(Node& node) {
+    Node* children = &(*nodes)[node.firstChild];
+    int32_t parentVisits = node.visits.load(std::memory_order_relaxed) +
+                           node.virtualLoss.load(std::memory_order_relaxed);
+    double logVisits = std::log(static_cast<double>(std::max(1, parentVisits)));
+
+    Node* best = children;
+    double bestValue = -1.0;
+    for (int i = 0; i < node.childCount; ++i) {
+        Node& child = children[i];
+        // Virtual losses count as visits that scored nothing, steering other
+        // threads away from paths already being explored.
+        int32_t visits = child.visits.load(std::memory_order_relaxed) +
+                         child.virtualLoss.load(std::memory_order_relaxed);
+        if (visits == 0) return &child;
+        double value = child.score.load(std::memory_order_relaxed) / (2.0 * visits) +
+                       EXPLORATION * std::sqrt(logVisits / visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = &child;
+        }
+    }
+    return best;
+}
+
+bool MCTSEngine::reuseTree(const Position& position) {
+    NodePool<Node>& pool = *nodes;
+    if (root < 0 || pool.size() > pool.capacity() / 2) return false;
+
+    BitBoard added[2];
+    for (int color = 0; color < 2; ++color) {
+        if (!rootPosition.stones[color].andNot(position.stones[color]).isEmpty()) return false;
+        added[color] = position.stones[color].andNot(rootPosition.stones[color]);
+    }
+
+    // Follow the stones played since the last search down the old tree.
+    int32_t current = root;
+    int toMove = rootPosition.toMove;
+    while (!added[toMove].isEmpty()) {
+        if (added[toMove].count() != 1) return false;
+        const Node& node = pool[current];
+        if (node.state.load() != EXPANDED) return false;
+
+        int move = added[toMove].nthSetBit(0);
+        int32_t next = -1;
+        for (int i = 0; i < node.childCount; ++i) {
+            if (pool[node.firstChild + i].move == move) next = node.firstChild + i;
+        }
+        if (next < 0) return false;
+
+        current = next;
+        added[toMove].clear(move);
+        toMove ^= 1;
+    }
+    if (!added[toMove ^ 1].isEmpty() || toMove != position.toMove) return false;
+
+    root = current;
+    rootPosition = position;
+    return true;
+}
+
+MCTSEngine::Position MCTSEngine::toPosition(const GameBoard& board, Player player) {
+    Position position;
+    position.stones[0] = BitBoard::fromGameBoard(board, Player::BLACK);
+    position.stones[1] = BitBoard::fromGameBoard(board, Player::WHITE);
+    BitBoard occupied = position.stones[0];
+    occupied |= position.stones[1];
+    position.empty = BitBoard::full().andNot(occupied);
+    for (int cell = 0; cell < BitBoard::CELLS; ++cell) {
+        if (occupied.test(cell)) position.candidates |= BitBoard::neighborhood(cell);
+    }
+    position.candidates &= position.empty;
+    position.toMove = (player == Player::BLACK) ? 0 : 1;
+    return position;
+}
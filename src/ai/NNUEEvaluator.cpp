@@ -0,0 +1,258 @@
+#include "ai/NNUEEvaluator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define NNUE_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+const int CELLS = GameBoard::BOARD_SIZE * GameBoard::BOARD_SIZE;
+const char* const MAGIC = "connect6-nnue";
+const int VERSION = 1;
+
+// Weight group of each window by how central it is: 0 near the centre, 2 at the edge.
+struct WindowBuckets {
+    uint8_t bucket[NNUEEvaluator::WINDOW_COUNT];
+
+    WindowBuckets() {
+        const BoardWindows& windows = BoardWindows::get();
+        const int size = GameBoard::BOARD_SIZE;
+        const double center = (size - 1) / 2.0;
+        for (int window = 0; window < NNUEEvaluator::WINDOW_COUNT; ++window) {
+            int first = windows.cells[window][0];
+            int last = windows.cells[window][GameBoard::WIN_LENGTH - 1];
+            double midRow = (first / size + last / size) / 2.0;
+            double midCol = (first % size + last % size) / 2.0;
+            double distance = std::max(std::abs(midRow - center), std::abs(midCol - center));
+            bucket[window] = distance < 2.5 ? 0 : (distance < 4.5 ? 1 : 2);
+        }
+    }
+};
+
+const WindowBuckets& windowBuckets() {
+    static const WindowBuckets buckets;
+    return buckets;
+}
+
+// accumulator += add - sub, for one row of HIDDEN int16 values
+void updateRow(int16_t* accumulator, const int16_t* add, const int16_t* sub) {
+#if defined(__AVX2__)
+    for (int i = 0; i < NNUEWeights::HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(accumulator + i));
+        a = _mm256_add_epi16(a, _mm256_load_si256(reinterpret_cast<const __m256i*>(add + i)));
+        a = _mm256_sub_epi16(a, _mm256_load_si256(reinterpret_cast<const __m256i*>(sub + i)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(accumulator + i), a);
+    }
+#elif defined(NNUE_SSE2)
+    for (int i = 0; i < NNUEWeights::HIDDEN; i += 8) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(accumulator + i));
+        a = _mm_add_epi16(a, _mm_load_si128(reinterpret_cast<const __m128i*>(add + i)));
+        a = _mm_sub_epi16(a, _mm_load_si128(reinterpret_cast<const __m128i*>(sub + i)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(accumulator + i), a);
+    }
+#elif defined(__ARM_NEON)
+    for (int i = 0; i < NNUEWeights::HIDDEN; i += 8) {
+        int16x8_t a = vld1q_s16(accumulator + i);
+        a = vsubq_s16(vaddq_s16(a, vld1q_s16(add + i)), vld1q_s16(sub + i));
+        vst1q_s16(accumulator + i, a);
+    }
+#else
+    for (int i = 0; i < NNUEWeights::HIDDEN; ++i) {
+        accumulator[i] = static_cast<int16_t>(accumulator[i] + add[i] - sub[i]);
+    }
+#endif
+}
+
+// sum of clamp(accumulator, 0, ACTIVATION_MAX) * weights over one row
+int32_t clippedDot(const int16_t* accumulator, const int16_t* weights) {
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i top = _mm256_set1_epi16(NNUEWeights::ACTIVATION_MAX);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < NNUEWeights::HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(accumulator + i));
+        a = _mm256_min_epi16(_mm256_max_epi16(a, zero), top);
+        __m256i w = _mm256_load_si256(reinterpret_cast<const __m256i*>(weights + i));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(a, w));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+    return _mm_cvtsi128_si32(half);
+#elif defined(NNUE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i top = _mm_set1_epi16(NNUEWeights::ACTIVATION_MAX);
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < NNUEWeights::HIDDEN; i += 8) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(accumulator + i));
+        a = _mm_min_epi16(_mm_max_epi16(a, zero), top);
+        __m128i w = _mm_load_si128(reinterpret_cast<const __m128i*>(weights + i));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(a, w));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+#elif defined(__ARM_NEON)
+    const int16x8_t zero = vdupq_n_s16(0);
+    const int16x8_t top = vdupq_n_s16(NNUEWeights::ACTIVATION_MAX);
+    int32x4_t sum = vdupq_n_s32(0);
+    for (int i = 0; i < NNUEWeights::HIDDEN; i += 8) {
+        int16x8_t a = vminq_s16(vmaxq_s16(vld1q_s16(accumulator + i), zero), top);
+        int16x8_t w = vld1q_s16(weights + i);
+        sum = vmlal_s16(sum, vget_low_s16(a), vget_low_s16(w));
+        sum = vmlal_s16(sum, vget_high_s16(a), vget_high_s16(w));
+    }
+    return vgetq_lane_s32(sum, 0) + vgetq_lane_s32(sum, 1) + vgetq_lane_s32(sum, 2) + vgetq_lane_s32(sum, 3);
+#else
+    int32_t sum = 0;
+    for (int i = 0; i < NNUEWeights::HIDDEN; ++i) {
+        int a = std::min<int>(std::max<int>(accumulator[i], 0), NNUEWeights::ACTIVATION_MAX);
+        sum += a * weights[i];
+    }
+    return sum;
+#endif
+}
+
+template <typename T>
+bool readValues(std::istream& in, T* values, int count) {
+    for (int i = 0; i < count; ++i) {
+        long value;
+        if (!(in >> value) || value < -32768 || value > 32767) return false;
+        values[i] = static_cast<T>(value);
+    }
+    return true;
+}
+
+std::mutex sharedMutex;
+std::string defaultPath = "connect6.nnue";
+
+} // namespace
+
+std::shared_ptr<const NNUEWeights> NNUEWeights::load(const std::string& path) {
+    std::ifstream in(path);
+    std::string magic;
+    int version = 0;
+    int hidden = 0;
+    if (!(in >> magic >> version >> hidden) || magic != MAGIC || version != VERSION || hidden != HIDDEN) {
+        return nullptr;
+    }
+
+    auto weights = std::make_shared<NNUEWeights>();
+    long bias = 0;
+    if (!readValues(in, &weights->features[0][0], FEATURES * HIDDEN) ||
+        !readValues(in, weights->hiddenBias, HIDDEN) ||
+        !readValues(in, weights->output, 2 * HIDDEN) ||
+        !(in >> bias >> weights->outputShift) ||
+        weights->outputShift < 0 || weights->outputShift > 30) {
+        return nullptr;
+    }
+    weights->outputBias = static_cast<int32_t>(bias);
+    return weights;
+}
+
+bool NNUEWeights::save(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    out << MAGIC << " " << VERSION << "\n" << HIDDEN << "\n";
+    for (int f = 0; f < FEATURES; ++f) {
+        for (int h = 0; h < HIDDEN; ++h) out << features[f][h] << (h + 1 < HIDDEN ? " " : "\n");
+    }
+    for (int h = 0; h < HIDDEN; ++h) out << hiddenBias[h] << (h + 1 < HIDDEN ? " " : "\n");
+    for (int h = 0; h < 2 * HIDDEN; ++h) out << output[h] << (h + 1 < 2 * HIDDEN ? " " : "\n");
+    out << outputBias << " " << outputShift << "\n";
+    return static_cast<bool>(out);
+}
+
+std::shared_ptr<const NNUEWeights> NNUEWeights::shared() {
+    static std::shared_ptr<const NNUEWeights> weights;
+    static bool loaded = false;
+
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    if (!loaded) {
+        const char* path = std::getenv("CONNECT6_NNUE");
+        weights = load(path ? path : defaultPath);
+        loaded = true;
+    }
+    return weights;
+}
+
+void NNUEWeights::setDefaultPath(const std::string& path) {
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    defaultPath = path;
+}
+
+NNUEEvaluator::NNUEEvaluator(std::shared_ptr<const NNUEWeights> weights)
+    : weights(std::move(weights))
+    , stones(0) {
+    windowBuckets();
+    reset(GameBoard());
+}
+
+int NNUEEvaluator::feature(int window, int perspective) const {
+    int own = counts[perspective][window];
+    int other = counts[perspective ^ 1][window];
+    int state = other == 0 ? own : (own == 0 ? GameBoard::WIN_LENGTH + other : NNUEWeights::WINDOW_STATES - 1);
+    return windowBuckets().bucket[window] * NNUEWeights::WINDOW_STATES + state;
+}
+
+void NNUEEvaluator::reset(const GameBoard& board) {
+    counts.reset(board);
+    stones = 0;
+    for (int cell = 0; cell < CELLS; ++cell) {
+        if (board.getCell(cell / GameBoard::BOARD_SIZE, cell % GameBoard::BOARD_SIZE) != Player::NONE) stones++;
+    }
+
+    for (int perspective = 0; perspective < 2; ++perspective) {
+        int32_t sums[NNUEWeights::HIDDEN];
+        for (int h = 0; h < NNUEWeights::HIDDEN; ++h) sums[h] = weights->hiddenBias[h];
+        for (int window = 0; window < WINDOW_COUNT; ++window) {
+            const int16_t* row = weights->features[feature(window, perspective)];
+            for (int h = 0; h < NNUEWeights::HIDDEN; ++h) sums[h] += row[h];
+        }
+        for (int h = 0; h < NNUEWeights::HIDDEN; ++h) {
+            accumulators[perspective][h] = static_cast<int16_t>(std::min(32767, std::max(-32768, sums[h])));
+        }
+    }
+}
+
+void NNUEEvaluator::updateCell(int cell, int color, int delta) {
+    for (int window : BoardWindows::get().windowsOf(cell)) {
+        int before[2] = {feature(window, 0), feature(window, 1)};
+        counts[color][window] = static_cast<uint8_t>(counts[color][window] + delta);
+        for (int perspective = 0; perspective < 2; ++perspective) {
+            int after = feature(window, perspective);
+            updateRow(accumulators[perspective], weights->features[after], weights->features[before[perspective]]);
+        }
+    }
+    stones += delta;
+}
+
+void NNUEEvaluator::onMakeMove(int row, int col, Player player) {
+    updateCell(row * GameBoard::BOARD_SIZE + col, colorIndex(player), 1);
+}
+
+void NNUEEvaluator::onUndoMove(int row, int col, Player player) {
+    updateCell(row * GameBoard::BOARD_SIZE + col, colorIndex(player), -1);
+}
+
+int NNUEEvaluator::evaluate(const GameBoard& board, Player player) {
+    // Callers that skipped the make/undo hooks get a full refresh.
+    if (board.getMoveCount() != stones) reset(board);
+
+    int us = player == Player::BLACK ? 0 : 1;
+    int32_t sum = weights->outputBias +
+                  clippedDot(accumulators[us], weights->output) +
+                  clippedDot(accumulators[us ^ 1], weights->output + NNUEWeights::HIDDEN);
+    return sum >> weights->outputShift;
+}
@@ -0,0 +1,96 @@
+#include "ai/OpeningBook.h"
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include "core/MoveNotation.h"
+
+namespace {
+
+const char* const MAGIC = "connect6-book";
+const int VERSION = 1;
+
+std::mutex sharedMutex;
+std::string defaultPath = "connect6.book";
+
+} // namespace
+
+std::shared_ptr<const OpeningBook> OpeningBook::load(const std::string& path) {
+    std::ifstream in(path);
+    std::string magic;
+    int version = 0;
+    if (!(in >> magic >> version) || magic != MAGIC || version != VERSION) return nullptr;
+
+    auto book = std::make_shared<OpeningBook>();
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream words(line);
+        std::vector<std::pair<int, int>> moves;
+        std::string text;
+        while (words >> text) {
+            std::pair<int, int> move;
+            if (!parseMove(text, move)) return nullptr;
+            moves.push_back(move);
+        }
+        if (!moves.empty() && !book->addLine(moves)) return nullptr;
+    }
+    return book;
+}
+
+bool OpeningBook::save(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << MAGIC << ' ' << VERSION << '\n';
+    for (const auto& moves : lines) {
+        for (size_t i = 0; i < moves.size(); ++i) out << (i ? " " : "") << formatMove(moves[i]);
+        out << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+std::shared_ptr<const OpeningBook> OpeningBook::shared() {
+    static std::shared_ptr<const OpeningBook> book;
+    static bool loaded = false;
+
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    if (!loaded) {
+        const char* path = std::getenv("CONNECT6_BOOK");
+        book = load(path ? path : defaultPath);
+        loaded = true;
+    }
+    return book;
+}
+
+void OpeningBook::setDefaultPath(const std::string& path) {
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    defaultPath = path;
+}
+
+bool OpeningBook::addLine(const std::vector<std::pair<int, int>>& moves) {
+    GameBoard board;
+    size_t played = 0;
+    for (const auto& move : moves) {
+        if (board.getGameState() != GameState::IN_PROGRESS || !board.isValidMove(move.first, move.second)) break;
+        // Stored in the canonical orientation, like the key.
+        auto canonical = GameBoard::transformMove(move.first, move.second, board.getCanonicalSymmetry());
+        replies.emplace(board.getCanonicalHash(),
+                        static_cast<uint8_t>(canonical.first * GameBoard::BOARD_SIZE + canonical.second));
+        board.makeMove(move.first, move.second, board.getCurrentPlayer());
+        played++;
+    }
+    lines.emplace_back(moves.begin(), moves.begin() + played);
+    return played == moves.size();
+}
+
+bool OpeningBook::probe(const GameBoard& board, std::pair<int, int>& move) const {
+    auto found = replies.find(board.getCanonicalHash());
+    if (found == replies.end()) return false;
+    move = GameBoard::inverseTransformMove(found->second / GameBoard::BOARD_SIZE, found->second % GameBoard::BOARD_SIZE,
+                                           board.getCanonicalSymmetry());
+    // A hash collision could name an occupied cell.
+    return board.isValidMove(move.first, move.second);
+}
+
+size_t OpeningBook::size() const {
+    return replies.size();
+}
@@ -0,0 +1,215 @@
+#include "ai/PatternEvaluator.h"
+#include "core/Profiler.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+
+namespace {
+
+const char* const MAGIC = "connect6-patterns";
+const int VERSION = 1;
+const char* const PATTERN_NAMES[PatternWeights::PATTERN_COUNT] = {
+    "six", "five", "open_four", "four", "open_three", "three", "open_two", "two"
+};
+
+std::mutex sharedMutex;
+std::string defaultPath = "connect6.weights";
+
+} // namespace
+
+std::shared_ptr<const PatternWeights> PatternWeights::load(const std::string& path) {
+    std::ifstream in(path);
+    std::string magic;
+    int version = 0;
+    if (!(in >> magic >> version) || magic != MAGIC || version != VERSION) return nullptr;
+
+    auto weights = std::make_shared<PatternWeights>();
+    std::string name;
+    int value;
+    while (in >> name >> value) {
+        if (name == "center" || name == "defense") {
+            (name == "center" ? weights->center : weights->defense) = value;
+            continue;
+        }
+        const char* const* found = std::find_if(PATTERN_NAMES, PATTERN_NAMES + PATTERN_COUNT,
+                                                [&](const char* pattern) { return name == pattern; });
+        if (found == PATTERN_NAMES + PATTERN_COUNT) return nullptr;
+        weights->patterns[found - PATTERN_NAMES] = value;
+    }
+    if (!in.eof()) return nullptr;
+    return weights;
+}
+
+bool PatternWeights::save(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    out << MAGIC << " " << VERSION << "\n";
+    for (int i = 0; i < PATTERN_COUNT; ++i) out << PATTERN_NAMES[i] << " " << patterns[i] << "\n";
+    out << "center " << center << "\n";
+    out << "defense " << defense << "\n";
+    return static_cast<bool>(out);
+}
+
+std::shared_ptr<const PatternWeights> PatternWeights::shared() {
+    static std::shared_ptr<const PatternWeights> weights;
+    static bool loaded = false;
+
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    if (!loaded) {
+        const char* path = std::getenv("CONNECT6_WEIGHTS");
+        weights = load(path ? path : defaultPath);
+        loaded = true;
+    }
+    return weights;
+}
+
+void PatternWeights::setDefaultPath(const std::string& path) {
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    defaultPath = path;
+}
+
+PatternEvaluator::PatternEvaluator(const PatternWeights& weights)
+    : weights(weights) {
+}
+
+const PatternWeights& PatternEvaluator::getWeights() const {
+    return weights;
+}
+
+void PatternEvaluator::setWeights(const PatternWeights& value) {
+    weights = value;
+}
+
+int PatternEvaluator::evaluate(const GameBoard& board, Player player) {
+    int score = 0;
+    Player opponent = (player == Player::BLACK) ? Player::WHITE : Player::BLACK;
+    
+    int centerX = GameBoard::BOARD_SIZE / 2;
+    int centerY = GameBoard::BOARD_SIZE / 2;
+    for (int i = -2; i <= 2; i++) {
+        for (int j = -2; j <= 2; j++) {
+            int x = centerX + i;
+            int y = centerY + j;
+            if (x >= 0 && x < GameBoard::BOARD_SIZE && y >= 0 && y < GameBoard::BOARD_SIZE) {
+                if (board.getCell(x, y) == player) {
+                    score += (3 - std::max(std::abs(i), std::abs(j))) * weights.center;
+                }
+            }
+        }
+    }
+    
+    for (int i = 0; i < GameBoard::BOARD_SIZE; ++i) {
+        for (int j = 0; j < GameBoard::BOARD_SIZE; ++j) {
+            if (board.getCell(i, j) == player) {
+                for (int di = -1; di <= 1; ++di) {
+                    for (int dj = -1; dj <= 1; ++dj) {
+                        if (di == 0 && dj == 0) continue;
+                        
+                        score += evaluatePattern(board, i, j, di, dj, player);
+                        score -= evaluatePattern(board, i, j, di, dj, opponent) * weights.defense / 100;
+                    }
+                }
+            }
+        }
+    }
+    
+    return score;
+}
+
+int PatternEvaluator::evaluatePattern(const GameBoard& board, int row, int col, int dRow, int dCol, Player player,
+                                      int* patternOut) const {
+    PROFILE_DETAIL_ZONE("evaluatePattern");
+    bool blocked;
+    int pattern = classifyPattern(board, row, col, dRow, dCol, player, blocked);
+    if (patternOut) *patternOut = pattern < 0 ? PatternWeights::PATTERN_COUNT : pattern;
+    if (pattern < 0) return 0;
+    if (pattern == PatternWeights::SIX) return weights.patterns[pattern];
+    
+    int score = weights.patterns[pattern];
+    if (blocked) score /= 2;
+    
+    return score;
+}
+
+void PatternEvaluator::getFeatures(const GameBoard& board, Player player, PatternFeatures& features) const {
+    features = PatternFeatures();
+    Player opponent = (player == Player::BLACK) ? Player::WHITE : Player::BLACK;
+    
+    int center = GameBoard::BOARD_SIZE / 2;
+    for (int i = 0; i < GameBoard::BOARD_SIZE; ++i) {
+        for (int j = 0; j < GameBoard::BOARD_SIZE; ++j) {
+            if (board.getCell(i, j) != player) continue;
+            
+            int distance = std::max(std::abs(i - center), std::abs(j - center));
+            if (distance <= 2) features.center += 3 - distance;
+            
+            for (int di = -1; di <= 1; ++di) {
+                for (int dj = -1; dj <= 1; ++dj) {
+                    if (di == 0 && dj == 0) continue;
+                    
+                    bool blocked;
+                    int pattern = classifyPattern(board, i, j, di, dj, player, blocked);
+                    if (pattern >= 0) features.own[pattern] += (blocked && pattern != PatternWeights::SIX) ? 0.5 : 1.0;
+                    pattern = classifyPattern(board, i, j, di, dj, opponent, blocked);
+                    if (pattern >= 0) features.opponent[pattern] += (blocked && pattern != PatternWeights::SIX) ? 0.5 : 1.0;
+                }
+            }
+        }
+    }
+}
+
+int PatternEvaluator::classifyPattern(const GameBoard& board, int row, int col, int dRow, int dCol, Player player, bool& blocked) const {
+    int count = 1;
+    int openEnds = 0;
+    int spaces = 0;
+    
+    int r = row + dRow;
+    int c = col + dCol;
+    blocked = false;
+    
+    while (r >= 0 && r < GameBoard::BOARD_SIZE && c >= 0 && c < GameBoard::BOARD_SIZE && spaces <= 2) {
+        if (board.getCell(r, c) == player) {
+            if (spaces == 0) count++;
+            else break;
+        } else if (board.getCell(r, c) == Player::NONE) {
+            spaces++;
+            if (spaces == 1) openEnds++;
+        } else {
+            blocked = true;
+            break;
+        }
+        r += dRow;
+        c += dCol;
+    }
+    spaces = 0;
+    
+    r = row - dRow;
+    c = col - dCol;
+    
+    while (r >= 0 && r < GameBoard::BOARD_SIZE && c >= 0 && c < GameBoard::BOARD_SIZE && spaces <= 2) {
+        if (board.getCell(r, c) == player) {
+            if (spaces == 0) count++;
+            else break;
+        } else if (board.getCell(r, c) == Player::NONE) {
+            spaces++;
+            if (spaces == 1) openEnds++;
+        } else {
+            blocked = true;
+            break;
+        }
+        r -= dRow;
+        c -= dCol;
+    }
+    
+    if (count >= 6) return PatternWeights::SIX;
+    if (count == 5 && openEnds > 0) return PatternWeights::FIVE;
+    if (count == 4 && openEnds == 2) return PatternWeights::OPEN_FOUR;
+    if (count == 4 && openEnds == 1) return PatternWeights::FOUR;
+    if (count == 3 && openEnds == 2) return PatternWeights::OPEN_THREE;
+    if (count == 3 && openEnds == 1) return PatternWeights::THREE;
+    if (count == 2 && openEnds == 2) return PatternWeights::OPEN_TWO;
+    if (count == 2 && openEnds == 1) return PatternWeights::TWO;
+    return -1;
+}
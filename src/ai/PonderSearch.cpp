@@ -0,0 +1,102 @@
+#include "ai/PonderSearch.h"
+#include "core/Metrics.h"
+#include "core/Profiler.h"
+
+PonderSearch::PonderSearch(GameAI& ai)
+    : ai(ai)
+    , human(Player::NONE)
+    , predicted(-1)
+    , reply(-1, -1)
+    , searched(false) {
+    predictor.setDifficulty(AIDifficulty::EASY);
+    predictor.setVerbose(false);
+}
+
+PonderSearch::~PonderSearch() {
+    cancel();
+}
+
+void PonderSearch::start(const GameBoard& board, Player humanPlayer) {
+    cancel();
+    if (board.getGameState() != GameState::IN_PROGRESS) return;
+
+    position = board;
+    human = humanPlayer;
+    predicted = -1;
+    reply = {-1, -1};
+    searched = false;
+    onReply = ReplyCallback();
+    ai.clearStopRequest();
+    predictor.clearStopRequest();
+    worker = std::thread(&PonderSearch::run, this);
+}
+
+void PonderSearch::run() {
+    Profiler::setThreadName("ponder");
+    std::pair<int, int> guess = predictor.getBestMove(position, human);
+    if (predictor.isStopRequested() || !position.makeMove(guess.first, guess.second, human)) return;
+    predicted = guess.first * GameBoard::BOARD_SIZE + guess.second;
+
+    std::pair<int, int> move = {-1, -1};
+    if (position.getGameState() == GameState::IN_PROGRESS) {
+        move = ai.getBestMove(position, position.getCurrentPlayer());
+    }
+    if (ai.isStopRequested()) return;
+
+    ReplyCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        reply = move;
+        searched = true;
+        callback = onReply;
+    }
+    if (callback && move.first >= 0) callback(move);
+}
+
+bool PonderSearch::finish(const std::pair<int, int>& played, std::pair<int, int>& answer,
+                          const ReplyCallback& pending) {
+    if (!worker.joinable()) return false;
+
+    if (predicted.load() != played.first * GameBoard::BOARD_SIZE + played.second) {
+        stop();
+        stats.misses++;
+        static MetricCounter& misses = MetricsRegistry::global().counter(
+            "connect6_ponder_misses_total", "Ponder searches discarded because the human played another move");
+        misses.add();
+        return false;
+    }
+
+    // Hit: the search already running is exactly the one the AI needs.
+    stats.hits++;
+    static MetricCounter& hits = MetricsRegistry::global().counter(
+        "connect6_ponder_hits_total", "Ponder searches whose predicted move was played");
+    hits.add();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (searched) {
+        answer = reply;
+        return reply.first >= 0;
+    }
+    answer = {-1, -1};
+    onReply = pending;
+    return true;
+}
+
+void PonderSearch::cancel() {
+    if (worker.joinable()) stop();
+}
+
+void PonderSearch::stop() {
+    predictor.requestStop();
+    ai.requestStop();
+    worker.join();
+    predictor.clearStopRequest();
+    ai.clearStopRequest();
+}
+
+bool PonderSearch::isActive() const {
+    return worker.joinable();
+}
+
+const PonderStats& PonderSearch::getStats() const {
+    return stats;
+}
@@ -0,0 +1,361 @@
+#include "ai/ProofSolver.h"
+#include <algorithm>
+
+namespace {
+
+const uint32_t INF = 0x3FFFFFFF;
+const int DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+const uint64_t WHITE_ATTACKER_KEY = 0xD1B54A32D192ED03ULL;
+
+uint32_t saturatingAdd(uint32_t a, uint32_t b) {
+    return std::min<uint32_t>(INF, a + b);
+}
+
+// Calls visit(row, col, dRow, dCol, blackCount, whiteCount) for every
+// six-cell window that fits on the board.
+template <typename Visitor>
+void forEachWindow(const GameBoard& board, Visitor visit) {
+    const int n = GameBoard::BOARD_SIZE;
+    const int len = GameBoard::WIN_LENGTH;
+    for (const auto& dir : DIRECTIONS) {
+        for (int row = 0; row < n; ++row) {
+            for (int col = 0; col < n; ++col) {
+                int endRow = row + dir[0] * (len - 1);
+                int endCol = col + dir[1] * (len - 1);
+                if (endRow < 0 || endRow >= n || endCol < 0 || endCol >= n) continue;
+
+                int black = 0;
+                int white = 0;
+                for (int k = 0; k < len; ++k) {
+                    Player cell = board.getCell(row + dir[0] * k, col + dir[1] * k);
+                    if (cell == Player::BLACK) black++;
+                    else if (cell == Player::WHITE) white++;
+                }
+                visit(row, col, dir[0], dir[1], black, white);
+            }
+        }
+    }
+}
+
+} // namespace
+
+ProofSolver::ProofSolver(size_t tableEntries, uint64_t nodeBudget)
+    : tableSize(0)
+    , tableUsed(0)
+    , tableProbes(0)
+    , tableHits(0)
+    , nodeBudget(nodeBudget)
+    , stopFlag(nullptr)
+    , nodes(0)
+    , aborted(false)
+    , attacker(Player::BLACK)
+    , rootMoveCount(0)
+    , rootMove(-1, -1)
+    , attackerLiveWindows(0) {
+    setTableEntries(tableEntries);
+}
+
+void ProofSolver::setNodeBudget(uint64_t budget) {
+    nodeBudget = budget;
+}
+
+void ProofSolver::setStopFlag(const std::atomic<bool>* flag) {
+    stopFlag = flag;
+}
+
+uint64_t ProofSolver::getNodeBudget() const {
+    return nodeBudget;
+}
+
+const ArenaStats& ProofSolver::getArenaStats() const {
+    return arena.getStats();
+}
+
+void ProofSolver::setTableEntries(size_t entries) {
+    tableSize = 1;
+    while (tableSize < entries) tableSize <<= 1;
+    std::vector<Entry>().swap(table);
+    tableUsed = 0;
+}
+
+double ProofSolver::getTableFill() const {
+    return static_cast<double>(tableUsed) / static_cast<double>(tableSize);
+}
+
+bool ProofSolver::isEndgame(const GameBoard& board) {
+    const int emptyCells = static_cast<int>(board.getValidMoves().size());
+    if (emptyCells <= ENDGAME_EMPTY_CELLS) return true;
+    return static_cast<int>(getLiveCells(board).size()) <= ENDGAME_LIVE_CELLS;
+}
+
+std::vector<std::pair<int, int>> ProofSolver::getLiveCells(const GameBoard& board) {
+    const int n = GameBoard::BOARD_SIZE;
+    std::vector<char> live(n * n, 0);
+    forEachWindow(board, [&](int row, int col, int dRow, int dCol, int black, int white) {
+        if (black > 0 && white > 0) return;
+        for (int k = 0; k < GameBoard::WIN_LENGTH; ++k) {
+            live[(row + dRow * k) * n + col + dCol * k] = 1;
+        }
+    });
+
+    std::vector<std::pair<int, int>> cells;
+    for (int row = 0; row < n; ++row) {
+        for (int col = 0; col < n; ++col) {
+            if (live[row * n + col] && board.getCell(row, col) == Player::NONE) {
+                cells.emplace_back(row, col);
+            }
+        }
+    }
+    return cells;
+}
+
+SolverResult ProofSolver::solve(const GameBoard& board, Player player) {
+    SolverResult result;
+    nodes = 0;
+    tableProbes = 0;
+    tableHits = 0;
+    if (board.getGameState() != GameState::IN_PROGRESS) return result;
+    if (table.empty()) table.assign(tableSize, Entry{0, 0, 0, 0});
+
+    GameBoard work;
+    work = board;
+
+    std::pair<int, int> move = {-1, -1};
+    ProofResult canWin = prove(work, player, move);
+    if (canWin == ProofResult::WIN) {
+        result.result = ProofResult::WIN;
+        result.bestMove = move;
+    } else if (canWin == ProofResult::LOSS) {
+        // We cannot force a win; check whether the opponent can.
+        ProofResult opponentWins = prove(work, getOpponent(player), move);
+        if (opponentWins == ProofResult::WIN) {
+            result.result = ProofResult::LOSS;
+        } else if (opponentWins == ProofResult::LOSS) {
+            result.result = ProofResult::DRAW;
+            result.bestMove = move;
+        }
+    }
+
+    result.nodes = nodes;
+    result.tableProbes = tableProbes;
+    result.tableHits = tableHits;
+    return result;
+}
+
+// Proves whether `attacker` can force six in a row from this position.
+// Returns WIN, LOSS (attacker cannot win) or UNKNOWN if the budget ran out.
+// On success `move` is the side to move's move that achieves its goal.
+ProofResult ProofSolver::prove(GameBoard& board, Player attacker, std::pair<int, int>& move) {
+    this->attacker = attacker;
+    aborted = false;
+    rootMove = {-1, -1};
+    rootMoveCount = board.getMoveCount();
+    resetWindows(board);
+    arena.reset();
+
+    uint32_t phi = 0;
+    uint32_t delta = 0;
+    mid(board, INF, INF, phi, delta);
+    if (aborted || (phi != 0 && delta != 0)) return ProofResult::UNKNOWN;
+
+    // phi == 0 means the side to move reached its goal: the attacker wins
+    // when it is to move, the defender holds otherwise.
+    move = (phi == 0) ? rootMove : std::pair<int, int>{-1, -1};
+    bool attackerToMove = board.getCurrentPlayer() == attacker;
+    bool attackerWins = attackerToMove ? (phi == 0) : (delta == 0);
+    return attackerWins ? ProofResult::WIN : ProofResult::LOSS;
+}
+
+void ProofSolver::mid(GameBoard& board, uint32_t thPhi, uint32_t thDelta, uint32_t& phi, uint32_t& delta) {
+    if (++nodes > nodeBudget || (stopFlag && stopFlag->load(std::memory_order_relaxed))) {
+        aborted = true;
+        phi = delta = 1;
+        return;
+    }
+
+    if (terminalValues(board, phi, delta)) {
+        store(board, phi, delta, 1);
+        return;
+    }
+
+    const uint64_t startNodes = nodes;
+    const int ply = board.getMoveCount() - rootMoveCount;
+    const Player player = board.getCurrentPlayer();
+    ScoredMove* moves = arena.moves(ply);
+    const int moveCount = getSolverMoves(board, moves);
+    const SearchArena::Mark mark = arena.mark();
+    uint32_t* childPhi = arena.allocate<uint32_t>(moveCount);
+    uint32_t* childDelta = arena.allocate<uint32_t>(moveCount);
+
+    for (int i = 0; i < moveCount; ++i) {
+        play(board, moves[i].move, player);
+        if (!terminalValues(board, childPhi[i], childDelta[i]) &&
+            !lookup(board, childPhi[i], childDelta[i])) {
+            childPhi[i] = childDelta[i] = 1;
+        }
+        unplay(board, moves[i].move, player);
+    }
+
+    while (true) {
+        phi = INF;
+        delta = 0;
+        int best = 0;
+        uint32_t secondDelta = INF;
+        for (int i = 0; i < moveCount; ++i) {
+            if (childDelta[i] < phi) {
+                secondDelta = phi;
+                phi = childDelta[i];
+                best = i;
+            } else if (childDelta[i] < secondDelta) {
+                secondDelta = childDelta[i];
+            }
+            delta = saturatingAdd(delta, childPhi[i]);
+        }
+
+        if (ply == 0 && phi == 0) rootMove = moves[best].move;
+        if (phi >= thPhi || delta >= thDelta || aborted) break;
+
+        uint32_t childThPhi = thDelta - (delta - childPhi[best]);
+        uint32_t childThDelta = std::min(thPhi, saturatingAdd(secondDelta, 1));
+        // Use the values mid() hands back rather than re-probing the table,
+        // which may already have evicted the child.
+        play(board, moves[best].move, player);
+        mid(board, childThPhi, childThDelta, childPhi[best], childDelta[best]);
+        unplay(board, moves[best].move, player);
+    }
+
+    arena.release(mark);
+    if (!aborted) {
+        store(board, phi, delta, static_cast<uint32_t>(std::min<uint64_t>(nodes - startNodes + 1, INF)));
+    }
+}
+
+bool ProofSolver::terminalValues(const GameBoard& board, uint32_t& phi, uint32_t& delta) const {
+    // Values are (proof, disproof) numbers for "attacker wins", expressed
+    // from the side to move: phi = pn/dn and delta = dn/pn at OR/AND nodes.
+    bool attackerWins = false;
+    switch (board.getGameState()) {
+        case GameState::BLACK_WIN:
+            attackerWins = attacker == Player::BLACK;
+            break;
+        case GameState::WHITE_WIN:
+            attackerWins = attacker == Player::WHITE;
+            break;
+        case GameState::DRAW:
+            break;
+        case GameState::IN_PROGRESS:
+            // Once every window holds a defender stone the attacker can never win.
+            if (attackerLiveWindows > 0) return false;
+            break;
+    }
+
+    uint32_t pn = attackerWins ? 0 : INF;
+    uint32_t dn = attackerWins ? INF : 0;
+    if (board.getCurrentPlayer() == attacker) {
+        phi = pn;
+        delta = dn;
+    } else {
+        phi = dn;
+        delta = pn;
+    }
+    return true;
+}
+
+bool ProofSolver::lookup(const GameBoard& board, uint32_t& phi, uint32_t& delta) const {
+    const uint64_t key = tableKey(board);
+    const Entry& entry = table[key & (table.size() - 1)];
+    tableProbes++;
+    if (entry.work == 0 || entry.key != key) return false;
+    tableHits++;
+    phi = entry.phi;
+    delta = entry.delta;
+    return true;
+}
+
+void ProofSolver::store(const GameBoard& board, uint32_t phi, uint32_t delta, uint32_t work) {
+    const uint64_t key = tableKey(board);
+    Entry& entry = table[key & (table.size() - 1)];
+    // Keep whichever entry cost more to compute, but always refresh our own key
+    // and never displace a solved entry with an unsolved one.
+    const bool solved = phi == 0 || delta == 0;
+    const bool entrySolved = entry.phi == 0 || entry.delta == 0;
+    if (entry.work != 0 && entry.key != key && (work < entry.work || (entrySolved && !solved))) return;
+    if (entry.work == 0) tableUsed++;
+    entry = Entry{key, phi, delta, std::max<uint32_t>(work, 1)};
+}
+
+uint64_t ProofSolver::tableKey(const GameBoard& board) const {
+    // Symmetric positions share an entry; proofs for either attacker coexist.
+    return board.getCanonicalHash() ^ (attacker == Player::WHITE ? WHITE_ATTACKER_KEY : 0);
+}
+
+void ProofSolver::resetWindows(const GameBoard& board) {
+    stonesInWindow.reset(board);
+    attackerLiveWindows = 0;
+    const int defender = colorIndex(getOpponent(attacker));
+    for (int w = 0; w < BoardWindows::COUNT; ++w) {
+        if (stonesInWindow[defender][w] == 0) attackerLiveWindows++;
+    }
+}
+
+void ProofSolver::play(GameBoard& board, const std::pair<int, int>& move, Player player) {
+    board.makeMove(move.first, move.second, player);
+    const int color = colorIndex(player);
+    const bool defender = player != attacker;
+    for (int w : BoardWindows::get().windowsOf(move.first * GameBoard::BOARD_SIZE + move.second)) {
+        if (defender && stonesInWindow[color][w] == 0) attackerLiveWindows--;
+        stonesInWindow[color][w]++;
+    }
+}
+
+void ProofSolver::unplay(GameBoard& board, const std::pair<int, int>& move, Player player) {
+    board.undoMove();
+    const int color = colorIndex(player);
+    const bool defender = player != attacker;
+    for (int w : BoardWindows::get().windowsOf(move.first * GameBoard::BOARD_SIZE + move.second)) {
+        stonesInWindow[color][w]--;
+        if (defender && stonesInWindow[color][w] == 0) attackerLiveWindows++;
+    }
+}
+
+int ProofSolver::getSolverMoves(const GameBoard& board, ScoredMove* moves) const {
+    const BoardWindows& windows = BoardWindows::get();
+    int count = 0;
+    std::pair<int, int> deadCell = {-1, -1};
+
+    for (int row = 0; row < GameBoard::BOARD_SIZE; ++row) {
+        for (int col = 0; col < GameBoard::BOARD_SIZE; ++col) {
+            if (board.getCell(row, col) != Player::NONE) continue;
+            int score = 0;
+            for (int w : windows.windowsOf(row * GameBoard::BOARD_SIZE + col)) {
+                int black = stonesInWindow[0][w];
+                int white = stonesInWindow[1][w];
+                if (black > 0 && white > 0) continue;
+                int stones = black + white;
+                score += 1 + stones * stones;
+            }
+            if (score > 0) {
+                moves[count++] = ScoredMove{{row, col}, score};
+            } else if (deadCell.first < 0) {
+                deadCell = {row, col};
+            }
+        }
+    }
+
+    // Live cells are tried first, busiest windows first, so ties in the proof
+    // numbers resolve towards the most forcing moves. Cells were generated in
+    // board order, which the tie-break keeps.
+    std::sort(moves, moves + count, [](const ScoredMove& a, const ScoredMove& b) {
+        if (a.score != b.score) return a.score > b.score;
+        return a.move < b.move;
+    });
+
+    // Stones on dead cells can never join a six for either side, so all dead
+    // cells are interchangeable tempo moves and one representative is enough.
+    if (deadCell.first >= 0) moves[count++] = ScoredMove{deadCell, 0};
+    return count;
+}
+
+Player ProofSolver::getOpponent(Player player) const {
+    return (player == Player::BLACK) ? Player::WHITE : Player::BLACK;
+}
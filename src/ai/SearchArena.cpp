@@ -0,0 +1,72 @@
+#include "ai/SearchArena.h"
+#include <algorithm>
+
+SearchArena::SearchArena(size_t scratchBytes)
+    : blockSize(scratchBytes)
+    , currentBlock(0)
+    , offset(0)
+    , used(0) {
+}
+
+ScoredMove* SearchArena::moves(int ply) {
+    if (!moveLists) {
+        moveLists.reset(new ScoredMove[static_cast<size_t>(MAX_PLY) * MAX_MOVES]);
+        stats.moveListBytes = sizeof(ScoredMove) * MAX_PLY * MAX_MOVES;
+        stats.heapAllocations++;
+    }
+    return &moveLists[static_cast<size_t>(ply) * MAX_MOVES];
+}
+
+SearchArena::Mark SearchArena::mark() const {
+    return Mark{currentBlock, offset};
+}
+
+void SearchArena::release(const Mark& mark) {
+    currentBlock = mark.block;
+    offset = mark.offset;
+    used = offset;
+    for (size_t i = 0; i < currentBlock; ++i) used += blockSizes[i];
+}
+
+void SearchArena::reset() {
+    currentBlock = 0;
+    offset = 0;
+    used = 0;
+    stats.resets++;
+}
+
+const ArenaStats& SearchArena::getStats() const {
+    return stats;
+}
+
+void* SearchArena::allocateBytes(size_t bytes, size_t alignment) {
+    stats.scratchAllocations++;
+    while (true) {
+        if (currentBlock < blocks.size()) {
+            size_t start = (offset + alignment - 1) & ~(alignment - 1);
+            if (start + bytes <= blockSizes[currentBlock]) {
+                used += start + bytes - offset;
+                offset = start + bytes;
+                stats.scratchPeak = std::max(stats.scratchPeak, used);
+                return blocks[currentBlock].get() + start;
+            }
+            if (currentBlock + 1 < blocks.size()) {
+                used += blockSizes[currentBlock] - offset;
+                currentBlock++;
+                offset = 0;
+                continue;
+            }
+            used += blockSizes[currentBlock] - offset;
+            currentBlock++;
+            offset = 0;
+        }
+
+        // Only reached while warming up or after a request larger than any
+        // seen before; the block is kept for every later search.
+        size_t size = std::max(blockSize, bytes + alignment);
+        blocks.emplace_back(new unsigned char[size]);
+        blockSizes.push_back(size);
+        stats.scratchCapacity += size;
+        stats.heapAllocations++;
+    }
+}
@@ -0,0 +1,211 @@
+#include "ai/SearchTrace.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include "core/GameBoard.h"
+#include "core/MoveNotation.h"
+
+namespace {
+
+const char MAGIC[8] = {'C', '6', 'T', 'R', 'A', 'C', 'E', '1'};
+
+enum Tag : uint8_t {
+    BEGIN = 1,      // hash (8 bytes, little endian), player, depth
+    ENTER = 2,      // cell
+    END = 3,        // cell, score
+    EXIT = 0x10     // | NodeKind; score
+};
+
+const uint8_t NO_CELL = 255;
+
+uint8_t toCell(const std::pair<int, int>& move) {
+    if (move.first < 0 || move.second < 0) return NO_CELL;
+    return static_cast<uint8_t>(move.first * GameBoard::BOARD_SIZE + move.second);
+}
+
+std::pair<int, int> fromCell(uint8_t cell) {
+    if (cell == NO_CELL) return {-1, -1};
+    return {cell / GameBoard::BOARD_SIZE, cell % GameBoard::BOARD_SIZE};
+}
+
+size_t putScore(uint8_t* out, int score) {
+    uint32_t value = (static_cast<uint32_t>(score) << 1) ^ static_cast<uint32_t>(score >> 31);
+    size_t size = 0;
+    while (value >= 0x80) {
+        out[size++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[size++] = static_cast<uint8_t>(value);
+    return size;
+}
+
+int getScore(const uint8_t* in, size_t available, size_t& size) {
+    uint32_t value = 0;
+    size = 0;
+    for (int shift = 0; size < available && shift < 35; shift += 7) {
+        uint8_t byte = in[size++];
+        value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) break;
+    }
+    return static_cast<int>(value >> 1) ^ -static_cast<int>(value & 1);
+}
+
+const char* const KIND_NAMES[] = {"leaf", "terminal", "interior", "cutoff", "stopped", "table"};
+
+} // namespace
+
+SearchTrace::SearchTrace()
+    : mode(Mode::RECORD)
+    , position(0)
+    , nodes(0)
+    , diverged(false) {
+}
+
+bool SearchTrace::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    out.write(MAGIC, sizeof(MAGIC));
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(out);
+}
+
+bool SearchTrace::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+    clear();
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    mode = Mode::VERIFY;
+    return true;
+}
+
+void SearchTrace::clear() {
+    mode = Mode::RECORD;
+    data.clear();
+    position = 0;
+    nodes = 0;
+    path.clear();
+    diverged = false;
+    divergence = TraceDivergence();
+}
+
+SearchTrace::Mode SearchTrace::getMode() const {
+    return mode;
+}
+
+uint64_t SearchTrace::getNodes() const {
+    return nodes;
+}
+
+size_t SearchTrace::getBytes() const {
+    return data.size();
+}
+
+bool SearchTrace::hasDivergence() const {
+    return diverged;
+}
+
+const TraceDivergence& SearchTrace::getDivergence() const {
+    return divergence;
+}
+
+bool SearchTrace::isComplete() const {
+    return mode == Mode::VERIFY && !diverged && position == data.size();
+}
+
+void SearchTrace::beginSearch(uint64_t hash, Player player, int depth) {
+    uint8_t event[11];
+    event[0] = BEGIN;
+    for (int i = 0; i < 8; ++i) event[1 + i] = static_cast<uint8_t>(hash >> (8 * i));
+    event[9] = static_cast<uint8_t>(player);
+    event[10] = static_cast<uint8_t>(depth);
+    path.clear();
+    put(event, sizeof(event));
+}
+
+void SearchTrace::enter(const std::pair<int, int>& move) {
+    uint8_t event[2] = {ENTER, toCell(move)};
+    put(event, sizeof(event));
+    path.push_back(move);
+    nodes++;
+}
+
+void SearchTrace::exit(NodeKind kind, int score) {
+    uint8_t event[6];
+    event[0] = static_cast<uint8_t>(EXIT | static_cast<uint8_t>(kind));
+    size_t size = 1 + putScore(event + 1, score);
+    put(event, size);
+    if (!path.empty()) path.pop_back();
+}
+
+void SearchTrace::endSearch(const std::pair<int, int>& move, int score) {
+    uint8_t event[7];
+    event[0] = END;
+    event[1] = toCell(move);
+    size_t size = 2 + putScore(event + 2, score);
+    put(event, size);
+}
+
+void SearchTrace::put(const uint8_t* event, size_t size) {
+    if (mode == Mode::RECORD) {
+        data.insert(data.end(), event, event + size);
+        return;
+    }
+    if (diverged) return;
+
+    size_t recorded = position < data.size() ? eventSize(position) : 0;
+    if (recorded == size && std::memcmp(&data[position], event, size) == 0) {
+        position += size;
+        return;
+    }
+    diverged = true;
+    divergence.node = nodes;
+    divergence.path = path;
+    divergence.expected = recorded ? describe(&data[position], recorded) : "end of trace";
+    divergence.actual = describe(event, size);
+}
+
+size_t SearchTrace::eventSize(size_t offset) const {
+    size_t available = data.size() - offset;
+    size_t scoreSize = 0;
+    switch (data[offset]) {
+        case BEGIN: return std::min<size_t>(11, available);
+        case ENTER: return std::min<size_t>(2, available);
+        case END:
+            if (available < 2) return available;
+            getScore(&data[offset + 2], available - 2, scoreSize);
+            return 2 + scoreSize;
+        default:
+            getScore(&data[offset + 1], available - 1, scoreSize);
+            return 1 + scoreSize;
+    }
+}
+
+std::string SearchTrace::describe(const uint8_t* event, size_t size) const {
+    std::ostringstream text;
+    size_t scoreSize;
+    switch (event[0]) {
+        case BEGIN: {
+            uint64_t hash = 0;
+            for (int i = 0; i < 8 && 1 + i < static_cast<int>(size); ++i) hash |= static_cast<uint64_t>(event[1 + i]) << (8 * i);
+            text << "begin hash " << std::hex << hash << std::dec;
+            if (size >= 11) text << " player " << int(event[9]) << " depth " << int(event[10]);
+            break;
+        }
+        case ENTER:
+            text << "enter " << (size > 1 ? formatMove(fromCell(event[1])) : "?");
+            break;
+        case END:
+            text << "end " << (size > 1 ? formatMove(fromCell(event[1])) : "?");
+            if (size > 2) text << " score " << getScore(event + 2, size - 2, scoreSize);
+            break;
+        default: {
+            int kind = event[0] & 0x0f;
+            text << (kind < 6 && (event[0] & 0xf0) == EXIT ? KIND_NAMES[kind] : "unknown");
+            if (size > 1) text << " score " << getScore(event + 1, size - 1, scoreSize);
+            break;
+        }
+    }
+    return text.str();
+}
@@ -0,0 +1,104 @@
+#include "ai/ThreatGenerator.h"
+#include <algorithm>
+
+namespace {
+
+const int CELLS = GameBoard::BOARD_SIZE * GameBoard::BOARD_SIZE;
+
+std::pair<int, int> toMove(int cell) {
+    return {cell / GameBoard::BOARD_SIZE, cell % GameBoard::BOARD_SIZE};
+}
+
+} // namespace
+
+ThreatGenerator::ThreatGenerator() {
+    reset(GameBoard());
+}
+
+void ThreatGenerator::reset(const GameBoard& board) {
+    cells.assign(CELLS, Player::NONE);
+    stones.clear();
+    for (auto& open : openWindows) std::fill(open, open + GameBoard::WIN_LENGTH + 1, 0);
+    for (auto& open : openWindows) open[0] = BoardWindows::COUNT;
+
+    for (int row = 0; row < GameBoard::BOARD_SIZE; ++row) {
+        for (int col = 0; col < GameBoard::BOARD_SIZE; ++col) {
+            Player player = board.getCell(row, col);
+            if (player != Player::NONE) onMakeMove(row, col, player);
+        }
+    }
+}
+
+void ThreatGenerator::onMakeMove(int row, int col, Player player) {
+    cells[row * GameBoard::BOARD_SIZE + col] = player;
+    update(row, col, player, 1);
+}
+
+void ThreatGenerator::onUndoMove(int row, int col, Player player) {
+    cells[row * GameBoard::BOARD_SIZE + col] = Player::NONE;
+    update(row, col, player, -1);
+}
+
+void ThreatGenerator::update(int row, int col, Player player, int delta) {
+    const int own = colorIndex(player);
+    const int other = 1 - own;
+    for (int w : BoardWindows::get().windowsOf(row * GameBoard::BOARD_SIZE + col)) {
+        // The window is open for a colour while the other has no stone in it.
+        if (stones[other][w] == 0) openWindows[own][stones[own][w]]--;
+        if (stones[own][w] == 0) openWindows[other][stones[other][w]]--;
+        stones[own][w] += delta;
+        if (stones[other][w] == 0) openWindows[own][stones[own][w]]++;
+        if (stones[own][w] == 0) openWindows[other][stones[other][w]]++;
+    }
+}
+
+bool ThreatGenerator::hasFive(Player player) const {
+    return openWindows[colorIndex(player)][GameBoard::WIN_LENGTH - 1] > 0;
+}
+
+bool ThreatGenerator::hasFour(Player player) const {
+    return openWindows[colorIndex(player)][GameBoard::WIN_LENGTH - 2] > 0;
+}
+
+int ThreatGenerator::getWinningCells(Player player, ScoredMove* moves) const {
+    if (!hasFive(player)) return 0;
+
+    const BoardWindows& windows = BoardWindows::get();
+    const int own = colorIndex(player);
+    bool listed[CELLS] = {};
+    int count = 0;
+    for (int w = 0; w < BoardWindows::COUNT; ++w) {
+        if (stones[own][w] != GameBoard::WIN_LENGTH - 1 || stones[1 - own][w] != 0) continue;
+        for (int cell : windows.cells[w]) {
+            if (cells[cell] != Player::NONE || listed[cell]) continue;
+            listed[cell] = true;
+            moves[count++] = ScoredMove{toMove(cell), 1};
+        }
+    }
+    return count;
+}
+
+int ThreatGenerator::getThreatMoves(Player player, ScoredMove* moves) const {
+    if (!hasFour(player)) return 0;
+
+    // fives[cell] counts the fours a stone on `cell` would turn into fives.
+    const BoardWindows& windows = BoardWindows::get();
+    const int own = colorIndex(player);
+    int fives[CELLS] = {};
+    for (int w = 0; w < BoardWindows::COUNT; ++w) {
+        if (stones[own][w] != GameBoard::WIN_LENGTH - 2 || stones[1 - own][w] != 0) continue;
+        for (int cell : windows.cells[w]) {
+            if (cells[cell] == Player::NONE) fives[cell]++;
+        }
+    }
+
+    int count = 0;
+    for (int cell = 0; cell < CELLS; ++cell) {
+        if (fives[cell] > 0) moves[count++] = ScoredMove{toMove(cell), fives[cell]};
+    }
+    std::sort(moves, moves + count, [](const ScoredMove& a, const ScoredMove& b) {
+        if (a.score != b.score) return a.score > b.score;
+        return a.move < b.move;
+    });
+    return count;
+}
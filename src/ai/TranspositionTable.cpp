@@ -0,0 +1,201 @@
+#include "ai/TranspositionTable.h"
+#include <climits>
+#include <cstdlib>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#endif
+
+namespace {
+
+const size_t HUGE_PAGE_BYTES = size_t(2) << 20;
+
+// Entry fields within the data word.
+const int MOVE_SHIFT = 32;
+const int DEPTH_SHIFT = 48;
+const int BOUND_SHIFT = 56;
+const int AGE_SHIFT = 58;
+
+int depthOf(uint64_t data) {
+    return static_cast<int8_t>(data >> DEPTH_SHIFT);
+}
+
+uint8_t ageOf(uint64_t data) {
+    return static_cast<uint8_t>(data >> AGE_SHIFT);
+}
+
+} // namespace
+
+TranspositionTable::TranspositionTable(size_t entries)
+    : buckets(nullptr)
+    , bucketCount(0)
+    , memory(nullptr)
+    , mappedBytes(0)
+    , age(1) {
+    setEntries(entries);
+}
+
+TranspositionTable::~TranspositionTable() {
+    release();
+}
+
+bool TranspositionTable::probe(uint64_t key, Entry& entry) const {
+    if (!buckets) return false;
+    const Bucket& bucket = buckets[key & (bucketCount - 1)];
+    for (const Slot& slot : bucket.entries) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if (data != 0 && ageOf(data) == age && (slot.check.load(std::memory_order_relaxed) ^ data) == key) {
+            unpack(key, data, entry);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, int score, int depth, Bound bound, int move) {
+    if (!buckets) return;
+    Bucket& bucket = buckets[key & (bucketCount - 1)];
+    Slot* target = nullptr;
+    int lowest = INT_MAX;
+    for (Slot& slot : bucket.entries) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        bool current = data != 0 && ageOf(data) == age;
+        if (current && (slot.check.load(std::memory_order_relaxed) ^ data) == key) {
+            // A bound without a move keeps the move already known for this position.
+            if (move < 0) move = static_cast<int16_t>(data >> MOVE_SHIFT);
+            target = &slot;
+            break;
+        }
+        int worth = current ? depthOf(data) : INT_MIN;
+        if (worth < lowest) {
+            lowest = worth;
+            target = &slot;
+        }
+    }
+    uint64_t data = pack(score, move, depth, bound, age);
+    target->data.store(data, std::memory_order_relaxed);
+    target->check.store(key ^ data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::prefetch(uint64_t key) const {
+    if (!buckets) return;
+    const Bucket* bucket = &buckets[key & (bucketCount - 1)];
+#if defined(_MSC_VER)
+    _mm_prefetch(reinterpret_cast<const char*>(bucket), _MM_HINT_T0);
+#else
+    __builtin_prefetch(bucket);
+#endif
+}
+
+void TranspositionTable::newSearch() {
+    // Entries only carry the age modulo AGE_CYCLE, so they are wiped before
+    // an age comes round again.
+    age = static_cast<uint8_t>((age + 1) & (AGE_CYCLE - 1));
+    if (age == 0) {
+        clear();
+        age = 1;
+    }
+}
+
+void TranspositionTable::clear() {
+    // A fresh mapping is zero and gives the old pages back, where zeroing
+    // them in place would touch every one.
+    release();
+    allocate();
+}
+
+void TranspositionTable::release() {
+    if (!memory) return;
+#if defined(__linux__)
+    munmap(memory, mappedBytes);
+#else
+    std::free(memory);
+#endif
+    memory = nullptr;
+    buckets = nullptr;
+    mappedBytes = 0;
+}
+
+void TranspositionTable::setEntries(size_t count) {
+    bucketCount = 1;
+    while (bucketCount * 2 * ENTRIES_PER_BUCKET <= count) bucketCount *= 2;
+    release();
+    allocate();
+}
+
+void TranspositionTable::setMegabytes(size_t megabytes) {
+    setEntries((megabytes << 20) / ENTRY_BYTES);
+}
+
+size_t TranspositionTable::getEntries() const {
+    return bucketCount * ENTRIES_PER_BUCKET;
+}
+
+size_t TranspositionTable::getBytes() const {
+    return bucketCount * sizeof(Bucket);
+}
+
+double TranspositionTable::getFill() const {
+    if (!buckets) return 0.0;
+    size_t sample = bucketCount < FILL_SAMPLE_BUCKETS ? bucketCount : FILL_SAMPLE_BUCKETS;
+    size_t used = 0;
+    for (size_t i = 0; i < sample; ++i) {
+        for (const Slot& slot : buckets[i].entries) {
+            if (slot.data.load(std::memory_order_relaxed) != 0) used++;
+        }
+    }
+    return static_cast<double>(used) / (sample * ENTRIES_PER_BUCKET);
+}
+
+uint64_t TranspositionTable::pack(int score, int move, int depth, Bound bound, uint8_t entryAge) {
+    return static_cast<uint32_t>(score)
+         | static_cast<uint64_t>(static_cast<uint16_t>(move)) << MOVE_SHIFT
+         | static_cast<uint64_t>(static_cast<uint8_t>(depth)) << DEPTH_SHIFT
+         | static_cast<uint64_t>(bound) << BOUND_SHIFT
+         | static_cast<uint64_t>(entryAge) << AGE_SHIFT;
+}
+
+void TranspositionTable::unpack(uint64_t key, uint64_t data, Entry& entry) {
+    entry.key = key;
+    entry.score = static_cast<int32_t>(static_cast<uint32_t>(data));
+    entry.move = static_cast<int16_t>(data >> MOVE_SHIFT);
+    entry.depth = static_cast<int8_t>(depthOf(data));
+    entry.bound = static_cast<Bound>((data >> BOUND_SHIFT) & 3);
+    entry.age = ageOf(data);
+}
+
+bool TranspositionTable::allocate() {
+    size_t bytes = getBytes();
+#if defined(__linux__)
+    // Anonymous pages are zero and only backed once touched. A table of a
+    // huge page or more is mapped one huge page larger and trimmed, so it
+    // starts on a huge page boundary and the kernel can back all of it with
+    // 2 MB pages: one TLB entry then covers 32768 buckets instead of 64.
+    size_t alignment = bytes >= HUGE_PAGE_BYTES ? HUGE_PAGE_BYTES : 0;
+    size_t length = bytes + alignment;
+    void* base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) return false;
+    char* start = static_cast<char*>(base);
+    if (alignment) {
+        uintptr_t address = reinterpret_cast<uintptr_t>(base);
+        size_t head = ((address + alignment - 1) & ~(alignment - 1)) - address;
+        if (head) munmap(base, head);
+        if (alignment - head) munmap(start + head + bytes, alignment - head);
+        start += head;
+#if defined(MADV_HUGEPAGE)
+        madvise(start, bytes, MADV_HUGEPAGE);
+#endif
+    }
+    memory = start;
+    mappedBytes = bytes;
+    buckets = reinterpret_cast<Bucket*>(start);
+#else
+    memory = std::calloc(bytes + sizeof(Bucket), 1);
+    if (!memory) return false;
+    uintptr_t address = reinterpret_cast<uintptr_t>(memory);
+    buckets = reinterpret_cast<Bucket*>((address + sizeof(Bucket) - 1) & ~(sizeof(Bucket) - 1));
+#endif
+    return true;
+}
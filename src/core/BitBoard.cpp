@@ -0,0 +1,64 @@
+#include "core/BitBoard.h"
+
+namespace {
+
+struct BitBoardTables {
+    BitBoard neighborhoods[BitBoard::CELLS];
+    BitBoard full;
+
+    BitBoardTables() {
+        const int n = GameBoard::BOARD_SIZE;
+        for (int row = 0; row < n; ++row) {
+            for (int col = 0; col < n; ++col) {
+                full.set(BitBoard::index(row, col));
+                for (int r = row - 2; r <= row + 2; ++r) {
+                    for (int c = col - 2; c <= col + 2; ++c) {
+                        if (r < 0 || r >= n || c < 0 || c >= n || (r == row && c == col)) continue;
+                        neighborhoods[BitBoard::index(row, col)].set(BitBoard::index(r, c));
+                    }
+                }
+            }
+        }
+    }
+};
+
+const BitBoardTables& tables() {
+    static const BitBoardTables instance;
+    return instance;
+}
+
+} // namespace
+
+const BitBoard& BitBoard::neighborhood(int index) {
+    return tables().neighborhoods[index];
+}
+
+const BitBoard& BitBoard::full() {
+    return tables().full;
+}
+
+bool BitBoard::makesLine(const BitBoard& stones, int index) {
+    // Stepping by these offsets along the padded layout walks a row, column
+    // or diagonal; the padding column stops row and diagonal runs at the edge.
+    static const int steps[4] = {1, STRIDE, STRIDE + 1, STRIDE - 1};
+    for (int step : steps) {
+        int count = 1;
+        for (int i = index + step; i < CELLS && stones.test(i); i += step) {
+            if (++count >= GameBoard::WIN_LENGTH) return true;
+        }
+        for (int i = index - step; i >= 0 && stones.test(i); i -= step) {
+            if (++count >= GameBoard::WIN_LENGTH) return true;
+        }
+    }
+    return false;
+}
+
+BitBoard BitBoard::fromGameBoard(const GameBoard& board, Player player) {
+    BitBoard result;
+    for (int row = 0; row < GameBoard::BOARD_SIZE; ++row) {
+        for (int col = 0; col < GameBoard::BOARD_SIZE; ++col) {
+            if (board.getCell(row, col) == player) result.set(index(row, col));
+        }
+    }
+    return result;
+}
@@ -0,0 +1,392 @@
+#include "core/GameArchive.h"
+#include "core/Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+const char MAGIC[8] = {'C', '6', 'A', 'R', 'C', 'H', 'V', '1'};
+const int CELL_COUNT = GameBoard::BOARD_SIZE * GameBoard::BOARD_SIZE;
+const int CENTER_CELL = CELL_COUNT / 2;     // "previous move" of the first move
+const size_t INDEX_ENTRY_BYTES = 28;        // offset, stored, raw, first game, game count
+const size_t TRAILER_BYTES = 20 + sizeof(MAGIC);  // index offset, block count, game count, magic
+
+void putVarint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool getVarint(const uint8_t* in, size_t size, size_t& pos, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (pos >= size) return false;
+        uint8_t byte = in[pos++];
+        value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+void put32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+void put64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+uint32_t get32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(in[i]) << (8 * i);
+    return value;
+}
+
+uint64_t get64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    return value;
+}
+
+// LZ77 in the style of LZ4: sequences of a token (literal count in the high
+// nibble, match length - 4 in the low one, 15 meaning "more bytes follow"),
+// the literals, then a 2-byte match offset. The last sequence has literals only.
+const size_t MIN_MATCH = 4;
+const size_t MAX_OFFSET = 65535;
+const int HASH_BITS = 14;
+
+uint32_t load32(const uint8_t* in) {
+    uint32_t value;
+    std::memcpy(&value, in, sizeof(value));
+    return value;
+}
+
+void putLength(std::vector<uint8_t>& out, size_t length) {
+    for (; length >= 255; length -= 255) out.push_back(255);
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+bool getLength(const uint8_t* in, size_t size, size_t& pos, size_t& length) {
+    uint8_t byte;
+    do {
+        if (pos >= size) return false;
+        byte = in[pos++];
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+void putSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalCount, size_t offset,
+                 size_t matchLength) {
+    size_t extra = matchLength ? matchLength - MIN_MATCH : 0;
+    out.push_back(static_cast<uint8_t>(std::min<size_t>(literalCount, 15) << 4 | std::min<size_t>(extra, 15)));
+    if (literalCount >= 15) putLength(out, literalCount - 15);
+    out.insert(out.end(), literals, literals + literalCount);
+    if (matchLength == 0) return;
+    out.push_back(static_cast<uint8_t>(offset));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (extra >= 15) putLength(out, extra - 15);
+}
+
+void lzCompress(const uint8_t* in, size_t size, std::vector<uint8_t>& out) {
+    std::vector<uint32_t> table(size_t(1) << HASH_BITS, 0);     // position + 1, 0 = none
+    size_t anchor = 0;
+    size_t pos = 0;
+    while (pos + MIN_MATCH <= size) {
+        uint32_t sequence = load32(in + pos);
+        uint32_t hash = (sequence * 2654435761u) >> (32 - HASH_BITS);
+        size_t candidate = table[hash];
+        table[hash] = static_cast<uint32_t>(pos + 1);
+        if (candidate == 0 || pos - (candidate - 1) > MAX_OFFSET || load32(in + candidate - 1) != sequence) {
+            pos++;
+            continue;
+        }
+        size_t match = candidate - 1;
+        size_t length = MIN_MATCH;
+        while (pos + length < size && in[match + length] == in[pos + length]) length++;
+        putSequence(out, in + anchor, pos - anchor, pos - match, length);
+        pos += length;
+        anchor = pos;
+    }
+    putSequence(out, in + anchor, size - anchor, 0, 0);
+}
+
+bool lzDecompress(const uint8_t* in, size_t size, uint8_t* out, size_t rawSize) {
+    size_t ip = 0;
+    size_t op = 0;
+    while (ip < size) {
+        uint8_t token = in[ip++];
+        size_t literals = token >> 4;
+        if (literals == 15 && !getLength(in, size, ip, literals)) return false;
+        if (literals > size - ip || literals > rawSize - op) return false;
+        std::memcpy(out + op, in + ip, literals);
+        ip += literals;
+        op += literals;
+        if (ip == size) break;
+
+        if (size - ip < 2) return false;
+        size_t offset = in[ip] | static_cast<size_t>(in[ip + 1]) << 8;
+        ip += 2;
+        size_t length = token & 15;
+        if (length == 15 && !getLength(in, size, ip, length)) return false;
+        length += MIN_MATCH;
+        if (offset == 0 || offset > op || length > rawSize - op) return false;
+        if (offset >= length) {
+            std::memcpy(out + op, out + op - offset, length);
+        } else {
+            // Overlapping match: a run repeating the last `offset` bytes.
+            for (size_t i = 0; i < length; ++i) out[op + i] = out[op + i - offset];
+        }
+        op += length;
+    }
+    return op == rawSize;
+}
+
+} // namespace
+
+GameArchiveWriter::GameArchiveWriter(int threads)
+    : threadCount(std::max(1, threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency())))
+    , blockBytes(DEFAULT_BLOCK_BYTES)
+    , gameCount(0)
+    , lastBytes(0) {
+}
+
+void GameArchiveWriter::setBlockBytes(size_t bytes) {
+    blockBytes = std::max<size_t>(1, bytes);
+}
+
+bool GameArchiveWriter::add(const std::vector<std::pair<int, int>>& moves) {
+    for (const auto& move : moves) {
+        if (move.first < 0 || move.first >= GameBoard::BOARD_SIZE || move.second < 0 ||
+            move.second >= GameBoard::BOARD_SIZE) {
+            return false;
+        }
+    }
+    if (blocks.empty() || blocks.back().sizes.size() + blocks.back().games.size() >= blockBytes) {
+        blocks.emplace_back();
+    }
+    Block& block = blocks.back();
+    size_t start = block.games.size();
+    putVarint(block.games, static_cast<uint32_t>(moves.size()));
+    int previous = CENTER_CELL;
+    for (const auto& move : moves) {
+        int cell = move.first * GameBoard::BOARD_SIZE + move.second;
+        int delta = cell - previous;
+        putVarint(block.games, (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31));
+        previous = cell;
+    }
+    putVarint(block.sizes, static_cast<uint32_t>(block.games.size() - start));
+    block.gameCount++;
+    gameCount++;
+    return true;
+}
+
+void GameArchiveWriter::add(const GameBoard& game) {
+    std::vector<std::pair<int, int>> moves;
+    for (int i = 0; i < game.getMoveCount(); ++i) moves.push_back(game.getMove(i));
+    add(moves);
+}
+
+size_t GameArchiveWriter::size() const {
+    return gameCount;
+}
+
+bool GameArchiveWriter::write(const std::string& path) {
+    PROFILE_ZONE("writeArchive");
+    // Blocks compress independently, so threads take them from a shared
+    // counter; the file is then written in block order.
+    std::vector<std::vector<uint8_t>> stored(blocks.size());
+    std::vector<uint32_t> rawBytes(blocks.size());
+    std::atomic<size_t> next(0);
+    auto work = [&]() {
+        std::vector<uint8_t> raw;
+        for (size_t i = next.fetch_add(1); i < blocks.size(); i = next.fetch_add(1)) {
+            raw.assign(blocks[i].sizes.begin(), blocks[i].sizes.end());
+            raw.insert(raw.end(), blocks[i].games.begin(), blocks[i].games.end());
+            rawBytes[i] = static_cast<uint32_t>(raw.size());
+            lzCompress(raw.data(), raw.size(), stored[i]);
+            // Incompressible blocks are kept as they are: equal sizes mean stored raw.
+            if (stored[i].size() >= raw.size()) stored[i] = raw;
+        }
+    };
+    size_t used = std::max<size_t>(1, std::min<size_t>(threadCount, blocks.size()));
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < used; ++t) threads.emplace_back(work);
+    work();
+    for (auto& thread : threads) thread.join();
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    out.write(MAGIC, sizeof(MAGIC));
+    std::vector<uint8_t> index;
+    uint64_t offset = sizeof(MAGIC);
+    uint64_t firstGame = 0;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        out.write(reinterpret_cast<const char*>(stored[i].data()), static_cast<std::streamsize>(stored[i].size()));
+        put64(index, offset);
+        put32(index, static_cast<uint32_t>(stored[i].size()));
+        put32(index, rawBytes[i]);
+        put64(index, firstGame);
+        put32(index, blocks[i].gameCount);
+        offset += stored[i].size();
+        firstGame += blocks[i].gameCount;
+    }
+    put64(index, offset);
+    put32(index, static_cast<uint32_t>(blocks.size()));
+    put64(index, gameCount);
+    index.insert(index.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    out.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size()));
+    lastBytes = offset + index.size();
+    return static_cast<bool>(out);
+}
+
+size_t GameArchiveWriter::getLastBytes() const {
+    return lastBytes;
+}
+
+GameArchiveReader::GameArchiveReader()
+    : gameCount(0)
+    , cachedBlock(SIZE_MAX) {
+}
+
+bool GameArchiveReader::open(const std::string& path) {
+    close();
+    file.open(path, std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+
+    file.seekg(0, std::ios::end);
+    uint64_t fileBytes = static_cast<uint64_t>(file.tellg());
+    if (fileBytes < sizeof(MAGIC) + TRAILER_BYTES) return false;
+    uint8_t trailer[TRAILER_BYTES];
+    file.seekg(static_cast<std::streamoff>(fileBytes - TRAILER_BYTES));
+    if (!file.read(reinterpret_cast<char*>(trailer), TRAILER_BYTES) ||
+        std::memcmp(trailer + 20, MAGIC, sizeof(MAGIC)) != 0) {
+        return false;
+    }
+    uint64_t indexOffset = get64(trailer);
+    uint32_t blockCount = get32(trailer + 8);
+    if (indexOffset < sizeof(MAGIC) ||
+        indexOffset + uint64_t(blockCount) * INDEX_ENTRY_BYTES + TRAILER_BYTES != fileBytes) {
+        return false;
+    }
+
+    std::vector<uint8_t> index(size_t(blockCount) * INDEX_ENTRY_BYTES);
+    file.seekg(static_cast<std::streamoff>(indexOffset));
+    if (!file.read(reinterpret_cast<char*>(index.data()), static_cast<std::streamsize>(index.size()))) return false;
+    uint64_t expectedOffset = sizeof(MAGIC);
+    uint64_t games = 0;
+    for (uint32_t i = 0; i < blockCount; ++i) {
+        const uint8_t* entry = index.data() + size_t(i) * INDEX_ENTRY_BYTES;
+        BlockInfo info{get64(entry), get32(entry + 8), get32(entry + 12), get64(entry + 16), get32(entry + 24)};
+        if (info.offset != expectedOffset || info.firstGame != games || info.storedBytes > info.rawBytes) return false;
+        expectedOffset += info.storedBytes;
+        games += info.gameCount;
+        blocks.push_back(info);
+    }
+    if (expectedOffset != indexOffset || games != get64(trailer + 12)) return false;
+    gameCount = games;
+    return true;
+}
+
+void GameArchiveReader::close() {
+    if (file.is_open()) file.close();
+    file.clear();
+    blocks.clear();
+    gameCount = 0;
+    cachedBlock = SIZE_MAX;
+}
+
+size_t GameArchiveReader::size() const {
+    return static_cast<size_t>(gameCount);
+}
+
+size_t GameArchiveReader::getBlockCount() const {
+    return blocks.size();
+}
+
+bool GameArchiveReader::read(size_t index, std::vector<std::pair<int, int>>& moves) {
+    if (index >= gameCount) return false;
+    auto after = std::upper_bound(blocks.begin(), blocks.end(), index,
+                                  [](size_t game, const BlockInfo& info) { return game < info.firstGame; });
+    size_t block = static_cast<size_t>(after - blocks.begin()) - 1;
+    return loadBlock(block) && decodeGame(index - blocks[block].firstGame, moves);
+}
+
+bool GameArchiveReader::read(size_t index, GameBoard& game) {
+    std::vector<std::pair<int, int>> moves;
+    game.reset();
+    if (!read(index, moves)) return false;
+    for (const auto& move : moves) {
+        if (!game.makeMove(move.first, move.second, game.getCurrentPlayer())) return false;
+    }
+    return true;
+}
+
+bool GameArchiveReader::scan(
+    const std::function<void(size_t index, const std::vector<std::pair<int, int>>& moves)>& visit) {
+    PROFILE_ZONE("scanArchive");
+    std::vector<std::pair<int, int>> moves;
+    for (size_t block = 0; block < blocks.size(); ++block) {
+        if (!loadBlock(block)) return false;
+        for (uint32_t game = 0; game < blocks[block].gameCount; ++game) {
+            if (!decodeGame(game, moves)) return false;
+            visit(static_cast<size_t>(blocks[block].firstGame) + game, moves);
+        }
+    }
+    return true;
+}
+
+bool GameArchiveReader::loadBlock(size_t block) {
+    if (block == cachedBlock) return true;
+    cachedBlock = SIZE_MAX;
+    const BlockInfo& info = blocks[block];
+    stored.resize(info.storedBytes);
+    raw.resize(info.rawBytes);
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(info.offset));
+    if (!file.read(reinterpret_cast<char*>(stored.data()), static_cast<std::streamsize>(stored.size()))) return false;
+    if (info.storedBytes == info.rawBytes) {
+        raw.swap(stored);
+    } else if (!lzDecompress(stored.data(), stored.size(), raw.data(), raw.size())) {
+        return false;
+    }
+
+    // The block starts with its games' sizes; the games follow.
+    gameOffsets.resize(size_t(info.gameCount) + 1);
+    size_t pos = 0;
+    std::vector<uint32_t> sizes(info.gameCount);
+    for (uint32_t& size : sizes) {
+        if (!getVarint(raw.data(), raw.size(), pos, size)) return false;
+    }
+    gameOffsets[0] = static_cast<uint32_t>(pos);
+    for (uint32_t i = 0; i < info.gameCount; ++i) {
+        if (sizes[i] > raw.size() - gameOffsets[i]) return false;
+        gameOffsets[i + 1] = gameOffsets[i] + sizes[i];
+    }
+    cachedBlock = block;
+    return true;
+}
+
+bool GameArchiveReader::decodeGame(size_t game, std::vector<std::pair<int, int>>& moves) const {
+    const uint8_t* data = raw.data();
+    size_t end = gameOffsets[game + 1];
+    size_t pos = gameOffsets[game];
+    uint32_t count;
+    if (!getVarint(data, end, pos, count) || count > static_cast<uint32_t>(CELL_COUNT)) return false;
+    moves.clear();
+    int previous = CENTER_CELL;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t zigzag;
+        if (!getVarint(data, end, pos, zigzag)) return false;
+        int cell = previous + (static_cast<int>(zigzag >> 1) ^ -static_cast<int>(zigzag & 1));
+        if (cell < 0 || cell >= CELL_COUNT) return false;
+        moves.emplace_back(cell / GameBoard::BOARD_SIZE, cell % GameBoard::BOARD_SIZE);
+        previous = cell;
+    }
+    return pos == end;
+}
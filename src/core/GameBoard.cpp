@@ -1,10 +1,62 @@
 #include "core/GameBoard.h"
+#include "core/Profiler.h"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 
+namespace {
+
+const int CELL_COUNT = GameBoard::BOARD_SIZE * GameBoard::BOARD_SIZE;
+
+// Symmetries 0-3 rotate the board by 0/90/180/270 degrees, 4-7 mirror the
+// columns first and then apply the same rotation.
+std::pair<int, int> applySymmetry(int row, int col, int symmetry) {
+    const int n = GameBoard::BOARD_SIZE - 1;
+    if (symmetry & 4) col = n - col;
+    switch (symmetry & 3) {
+        case 1: return {col, n - row};
+        case 2: return {n - row, n - col};
+        case 3: return {n - col, row};
+        default: return {row, col};
+    }
+}
+
+struct ZobristTables {
+    uint64_t keys[CELL_COUNT][2];
+    int symmetricCell[GameBoard::SYMMETRY_COUNT][CELL_COUNT];
+
+    ZobristTables() {
+        // splitmix64 with a fixed seed keeps hashes identical across runs and builds
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (int cell = 0; cell < CELL_COUNT; ++cell) {
+            for (int color = 0; color < 2; ++color) {
+                uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                keys[cell][color] = z ^ (z >> 31);
+            }
+        }
+        for (int s = 0; s < GameBoard::SYMMETRY_COUNT; ++s) {
+            for (int row = 0; row < GameBoard::BOARD_SIZE; ++row) {
+                for (int col = 0; col < GameBoard::BOARD_SIZE; ++col) {
+                    auto [r, c] = applySymmetry(row, col, s);
+                    symmetricCell[s][row * GameBoard::BOARD_SIZE + col] = r * GameBoard::BOARD_SIZE + c;
+                }
+            }
+        }
+    }
+};
+
+const ZobristTables& zobrist() {
+    static const ZobristTables tables;
+    return tables;
+}
+
+} // namespace
+
 GameBoard::GameBoard() : currentPlayer(Player::BLACK), gameState(GameState::IN_PROGRESS) {
     board.resize(BOARD_SIZE, std::vector<Player>(BOARD_SIZE, Player::NONE));
+    hashes.fill(0);
 }
 
 GameBoard& GameBoard::operator=(const GameBoard& other) {
@@ -13,11 +65,13 @@ GameBoard& GameBoard::operator=(const GameBoard& other) {
         moveHistory = other.moveHistory;
         currentPlayer = other.currentPlayer;
         gameState = other.gameState;
+        hashes = other.hashes;
     }
     return *this;
 }
 
 bool GameBoard::makeMove(int row, int col, Player player) {
+    PROFILE_ZONE("makeMove");
     if (row < 0 || row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE ||
         board[row][col] != Player::NONE || gameState != GameState::IN_PROGRESS ||
         player != currentPlayer) {
@@ -26,6 +80,7 @@ bool GameBoard::makeMove(int row, int col, Player player) {
 
     board[row][col] = player;
     moveHistory.emplace_back(row, col, player);
+    updateHashes(row, col, player);
 
     if (checkWin(row, col, player)) {
         gameState = (player == Player::BLACK) ? GameState::BLACK_WIN : GameState::WHITE_WIN;
@@ -59,6 +114,7 @@ void GameBoard::reset() {
     board = std::vector<std::vector<Player>>(BOARD_SIZE, std::vector<Player>(BOARD_SIZE, Player::NONE));
     moveHistory.clear();
     winningLine.clear();
+    hashes.fill(0);
     currentPlayer = Player::BLACK;
     gameState = GameState::IN_PROGRESS;
     emit boardChanged();
@@ -70,6 +126,7 @@ void GameBoard::undoLastMove() {
 
     auto [row, col, player] = moveHistory.back();
     board[row][col] = Player::NONE;
+    updateHashes(row, col, player);
     moveHistory.pop_back();
     currentPlayer = player;
     gameState = GameState::IN_PROGRESS;
@@ -80,6 +137,7 @@ void GameBoard::undoMove() {
     if (!moveHistory.empty()) {
         auto [row, col, player] = moveHistory.back();
         board[row][col] = Player::NONE;
+        updateHashes(row, col, player);
         moveHistory.pop_back();
         currentPlayer = player;
         gameState = GameState::IN_PROGRESS;
@@ -106,6 +164,14 @@ std::string GameBoard::getMoveHistory() const {
     return ss.str();
 }
 
+int GameBoard::getMoveCount() const {
+    return static_cast<int>(moveHistory.size());
+}
+
+std::pair<int, int> GameBoard::getMove(int index) const {
+    return {std::get<0>(moveHistory[index]), std::get<1>(moveHistory[index])};
+}
+
 void GameBoard::saveGame(const std::string& filename) const {
     std::ofstream file(filename);
     if (!file) return;
@@ -216,6 +282,45 @@ bool GameBoard::checkDirection(int row, int col, int dRow, int dCol, Player play
     return count >= WIN_LENGTH;
 }
 
-std::vector<std::pair<int, int>> GameBoard::getWinningLine() const {
+const std::vector<std::pair<int, int>>& GameBoard::getWinningLine() const {
     return winningLine;
-} 
\ No newline at end of file
+}
+
+uint64_t GameBoard::getHash() const {
+    return hashes[0];
+}
+
+uint64_t GameBoard::getCanonicalHash() const {
+    return hashes[getCanonicalSymmetry()];
+}
+
+int GameBoard::getCanonicalSymmetry() const {
+    int best = 0;
+    for (int s = 1; s < SYMMETRY_COUNT; ++s) {
+        if (hashes[s] < hashes[best]) best = s;
+    }
+    return best;
+}
+
+std::pair<int, int> GameBoard::transformMove(int row, int col, int symmetry) {
+    return applySymmetry(row, col, symmetry);
+}
+
+std::pair<int, int> GameBoard::inverseTransformMove(int row, int col, int symmetry) {
+    return applySymmetry(row, col, inverseSymmetry(symmetry));
+}
+
+int GameBoard::inverseSymmetry(int symmetry) {
+    // Mirrors are involutions; only the 90 and 270 degree rotations swap.
+    static const int inverse[SYMMETRY_COUNT] = {0, 3, 2, 1, 4, 5, 6, 7};
+    return inverse[symmetry];
+}
+
+void GameBoard::updateHashes(int row, int col, Player player) {
+    const ZobristTables& tables = zobrist();
+    const int cell = row * BOARD_SIZE + col;
+    const int color = (player == Player::BLACK) ? 0 : 1;
+    for (int s = 0; s < SYMMETRY_COUNT; ++s) {
+        hashes[s] ^= tables.keys[tables.symmetricCell[s][cell]][color];
+    }
+}
@@ -0,0 +1,94 @@
+#include "core/GameTimeline.h"
+#include "core/Profiler.h"
+#include <algorithm>
+#include <cstdlib>
+
+GameTimeline::GameTimeline() {
+    clear();
+}
+
+void GameTimeline::clear() {
+    moves.clear();
+    plyHashes.assign(1, 0);
+    snapshots.assign(1, Snapshot{});
+    end.reset();
+}
+
+void GameTimeline::sync(const GameBoard& game) {
+    if (contains(game)) return;
+    int count = game.getMoveCount();
+    int common = 0;
+    int limit = std::min(count, size());
+    while (common < limit && game.moveHistory[common] == moves[common]) ++common;
+    truncate(common);
+    for (int i = common; i < count; ++i) {
+        auto [row, col, player] = game.moveHistory[i];
+        append(row, col, player);
+    }
+}
+
+int GameTimeline::size() const {
+    return static_cast<int>(moves.size());
+}
+
+bool GameTimeline::contains(const GameBoard& board) const {
+    int count = board.getMoveCount();
+    return count <= size() && board.getHash() == plyHashes[count];
+}
+
+bool GameTimeline::seek(GameBoard& board, int ply) const {
+    PROFILE_ZONE("seekTimeline");
+    if (ply < 0 || ply > size()) return false;
+
+    // A finished game's last position comes from replaying its last move,
+    // which sets the result and the winning line.
+    int replayFrom = ply == size() && ply > 0 ? ply - 1 : ply;
+    int snapshotPly = replayFrom / SNAPSHOT_INTERVAL * SNAPSHOT_INTERVAL;
+    int current = board.getMoveCount();
+    if (!contains(board) || std::abs(ply - current) > ply - snapshotPly) {
+        restore(board, snapshotPly);
+        current = snapshotPly;
+    }
+    for (; current < ply; ++current) {
+        auto [row, col, player] = moves[current];
+        board.makeMove(row, col, player);
+    }
+    for (; current > ply; --current) board.undoMove();
+    emit board.boardChanged();
+    return true;
+}
+
+void GameTimeline::truncate(int count) {
+    while (end.getMoveCount() > count) end.undoMove();
+    moves.resize(count);
+    plyHashes.resize(count + 1);
+    snapshots.resize(count / SNAPSHOT_INTERVAL + 1);
+}
+
+void GameTimeline::append(int row, int col, Player player) {
+    end.makeMove(row, col, player);
+    moves.emplace_back(row, col, player);
+    plyHashes.push_back(end.getHash());
+    if (size() % SNAPSHOT_INTERVAL == 0) {
+        snapshots.push_back(Snapshot{{BitBoard::fromGameBoard(end, Player::BLACK),
+                                      BitBoard::fromGameBoard(end, Player::WHITE)},
+                                     end.hashes});
+    }
+}
+
+void GameTimeline::restore(GameBoard& board, int ply) const {
+    const Snapshot& snapshot = snapshots[ply / SNAPSHOT_INTERVAL];
+    for (int row = 0; row < GameBoard::BOARD_SIZE; ++row) {
+        for (int col = 0; col < GameBoard::BOARD_SIZE; ++col) {
+            int index = BitBoard::index(row, col);
+            board.board[row][col] = snapshot.stones[0].test(index)   ? Player::BLACK
+                                    : snapshot.stones[1].test(index) ? Player::WHITE
+                                                                     : Player::NONE;
+        }
+    }
+    board.moveHistory.assign(moves.begin(), moves.begin() + ply);
+    board.hashes = snapshot.hashes;
+    board.currentPlayer = ply == 0 || std::get<2>(moves[ply - 1]) == Player::WHITE ? Player::BLACK : Player::WHITE;
+    board.gameState = GameState::IN_PROGRESS;
+    board.winningLine.clear();
+}
@@ -0,0 +1,208 @@
+#include "core/Metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+// Shortest text that reads back as the same double, "+Inf" for infinity.
+std::string formatNumber(double value) {
+    if (std::isinf(value)) return value > 0 ? "+Inf" : "-Inf";
+    if (std::isnan(value)) return "NaN";
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.17g", value);
+    for (int precision = 1; precision < 17; ++precision) {
+        char shorter[32];
+        std::snprintf(shorter, sizeof(shorter), "%.*g", precision, value);
+        if (std::strtod(shorter, nullptr) == value) return shorter;
+    }
+    return text;
+}
+
+// JSON has no infinity or NaN; report them as null.
+std::string formatJsonNumber(double value) {
+    return std::isfinite(value) ? formatNumber(value) : "null";
+}
+
+void addDouble(std::atomic<double>& target, double amount) {
+    double current = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(current, current + amount, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+MetricHistogram::MetricHistogram(const std::vector<double>& bounds)
+    : bounds(bounds)
+    , counts(new std::atomic<uint64_t>[bounds.size() + 1]) {
+    std::sort(this->bounds.begin(), this->bounds.end());
+    for (size_t i = 0; i <= bounds.size(); ++i) counts[i].store(0, std::memory_order_relaxed);
+}
+
+void MetricHistogram::observe(double value) {
+    size_t bucket = std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin();
+    counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    addDouble(sum, value);
+}
+
+uint64_t MetricHistogram::getCount() const {
+    uint64_t total = 0;
+    for (size_t i = 0; i <= bounds.size(); ++i) total += getBucketCount(i);
+    return total;
+}
+
+double MetricHistogram::getSum() const {
+    return sum.load(std::memory_order_relaxed);
+}
+
+double MetricHistogram::quantile(double q) const {
+    std::vector<uint64_t> snapshot(bounds.size() + 1);
+    uint64_t total = 0;
+    for (size_t i = 0; i < snapshot.size(); ++i) {
+        snapshot[i] = getBucketCount(i);
+        total += snapshot[i];
+    }
+    if (total == 0) return 0.0;
+
+    double rank = std::max(0.0, std::min(1.0, q)) * static_cast<double>(total);
+    uint64_t below = 0;
+    for (size_t i = 0; i < snapshot.size(); ++i) {
+        if (snapshot[i] == 0 || below + snapshot[i] < rank) {
+            below += snapshot[i];
+            continue;
+        }
+        // The +Inf bucket has no upper edge; its best estimate is the last bound.
+        if (i == bounds.size()) return bounds.empty() ? 0.0 : bounds.back();
+        double lower = i == 0 ? 0.0 : bounds[i - 1];
+        double fraction = (rank - static_cast<double>(below)) / static_cast<double>(snapshot[i]);
+        return lower + (bounds[i] - lower) * fraction;
+    }
+    return bounds.empty() ? 0.0 : bounds.back();
+}
+
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::Entry* MetricsRegistry::find(const std::string& name, Type type) {
+    for (const std::unique_ptr<Entry>& entry : entries) {
+        if (entry->name == name && entry->type == type) return entry.get();
+    }
+    return nullptr;
+}
+
+MetricCounter& MetricsRegistry::counter(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (Entry* entry = find(name, Type::COUNTER)) return *entry->counter;
+    entries.emplace_back(new Entry{name, help, Type::COUNTER, std::unique_ptr<MetricCounter>(new MetricCounter()),
+                                   nullptr, nullptr});
+    return *entries.back()->counter;
+}
+
+MetricGauge& MetricsRegistry::gauge(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (Entry* entry = find(name, Type::GAUGE)) return *entry->gauge;
+    entries.emplace_back(new Entry{name, help, Type::GAUGE, nullptr, std::unique_ptr<MetricGauge>(new MetricGauge()),
+                                   nullptr});
+    return *entries.back()->gauge;
+}
+
+MetricHistogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                            const std::vector<double>& bounds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (Entry* entry = find(name, Type::HISTOGRAM)) return *entry->histogram;
+    entries.emplace_back(new Entry{name, help, Type::HISTOGRAM, nullptr, nullptr,
+                                   std::unique_ptr<MetricHistogram>(new MetricHistogram(bounds))});
+    return *entries.back()->histogram;
+}
+
+std::vector<double> MetricsRegistry::latencyBuckets() {
+    return {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30, 60};
+}
+
+void MetricsRegistry::writePrometheus(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const std::unique_ptr<Entry>& entry : entries) {
+        out << "# HELP " << entry->name << " " << entry->help << "\n";
+        switch (entry->type) {
+        case Type::COUNTER:
+            out << "# TYPE " << entry->name << " counter\n"
+                << entry->name << " " << entry->counter->get() << "\n";
+            break;
+        case Type::GAUGE:
+            out << "# TYPE " << entry->name << " gauge\n"
+                << entry->name << " " << formatNumber(entry->gauge->get()) << "\n";
+            break;
+        case Type::HISTOGRAM: {
+            const MetricHistogram& histogram = *entry->histogram;
+            const std::vector<double>& bounds = histogram.getBounds();
+            out << "# TYPE " << entry->name << " histogram\n";
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i <= bounds.size(); ++i) {
+                cumulative += histogram.getBucketCount(i);
+                double bound = i < bounds.size() ? bounds[i] : INFINITY;
+                out << entry->name << "_bucket{le=\"" << formatNumber(bound) << "\"} " << cumulative << "\n";
+            }
+            out << entry->name << "_sum " << formatNumber(histogram.getSum()) << "\n"
+                << entry->name << "_count " << cumulative << "\n";
+            break;
+        }
+        }
+    }
+}
+
+void MetricsRegistry::writeJson(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    const char* sections[] = {"counters", "gauges", "histograms"};
+    const Type types[] = {Type::COUNTER, Type::GAUGE, Type::HISTOGRAM};
+    out << "{";
+    for (int section = 0; section < 3; ++section) {
+        out << (section ? ",\n" : "\n") << "\"" << sections[section] << "\":{";
+        bool first = true;
+        for (const std::unique_ptr<Entry>& entry : entries) {
+            if (entry->type != types[section]) continue;
+            out << (first ? "\n" : ",\n") << "  \"" << entry->name << "\":";
+            first = false;
+            if (entry->type == Type::COUNTER) {
+                out << entry->counter->get();
+            } else if (entry->type == Type::GAUGE) {
+                out << formatJsonNumber(entry->gauge->get());
+            } else {
+                const MetricHistogram& histogram = *entry->histogram;
+                const std::vector<double>& bounds = histogram.getBounds();
+                out << "{\"count\":" << histogram.getCount()
+                    << ",\"sum\":" << formatJsonNumber(histogram.getSum())
+                    << ",\"p50\":" << formatJsonNumber(histogram.quantile(0.5))
+                    << ",\"p90\":" << formatJsonNumber(histogram.quantile(0.9))
+                    << ",\"p99\":" << formatJsonNumber(histogram.quantile(0.99))
+                    << ",\"buckets\":[";
+                for (size_t i = 0; i <= bounds.size(); ++i) {
+                    if (i) out << ",";
+                    out << "[" << (i < bounds.size() ? formatNumber(bounds[i]) : "null") << ","
+                        << histogram.getBucketCount(i) << "]";
+                }
+                out << "]}";
+            }
+        }
+        out << (first ? "}" : "\n}");
+    }
+    out << "\n}\n";
+}
+
+bool MetricsRegistry::dump(const std::string& path) const {
+    const std::string suffix = ".json";
+    const bool json = path.size() >= suffix.size()
+        && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary);
+        if (!out) return false;
+        if (json) writeJson(out);
+        else writePrometheus(out);
+        if (!out) return false;
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
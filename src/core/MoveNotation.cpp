@@ -0,0 +1,22 @@
+#include "core/MoveNotation.h"
+#include <cctype>
+#include "core/GameBoard.h"
+
+std::string formatMove(const std::pair<int, int>& move) {
+    if (move.first < 0 || move.second < 0) return "none";
+    return std::string(1, static_cast<char>('a' + move.second)) + std::to_string(move.first + 1);
+}
+
+bool parseMove(const std::string& text, std::pair<int, int>& move) {
+    if (text.size() < 2 || text.size() > 3) return false;
+    int col = std::tolower(static_cast<unsigned char>(text[0])) - 'a';
+    int row = 0;
+    for (size_t i = 1; i < text.size(); ++i) {
+        if (!std::isdigit(static_cast<unsigned char>(text[i]))) return false;
+        row = row * 10 + (text[i] - '0');
+    }
+    row -= 1;
+    if (row < 0 || row >= GameBoard::BOARD_SIZE || col < 0 || col >= GameBoard::BOARD_SIZE) return false;
+    move = {row, col};
+    return true;
+}
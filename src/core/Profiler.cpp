@@ -0,0 +1,197 @@
+#include "core/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// Ring slots are atomics so an export can read them while the owning thread
+// keeps writing; relaxed accesses compile to plain moves.
+struct Event {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> beginNs{0};
+    std::atomic<uint64_t> endNs{0};
+};
+
+struct ThreadRing {
+    std::unique_ptr<Event[]> events{new Event[Profiler::RING_CAPACITY]};
+    // Index of the next event to write; only the owning thread stores it.
+    std::atomic<uint64_t> head{0};
+    // Events before this index were dropped by clear().
+    std::atomic<uint64_t> start{0};
+    int threadId = 0;
+    // Guarded by registryMutex. A ring whose thread exited is handed to the
+    // next new thread, so threads that come and go (one ponder search per
+    // move) do not each keep a ring alive.
+    std::string threadName;
+    bool inUse = true;
+};
+
+const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+std::mutex registryMutex;
+// Rings outlive their threads so short-lived workers still show up in exports.
+std::vector<std::shared_ptr<ThreadRing>> registry;
+
+struct LocalRing {
+    std::shared_ptr<ThreadRing> ring;
+
+    ~LocalRing() {
+        if (!ring) return;
+        std::lock_guard<std::mutex> lock(registryMutex);
+        ring->inUse = false;
+    }
+};
+thread_local LocalRing localRing;
+
+ThreadRing& threadRing() {
+    if (!localRing.ring) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const std::shared_ptr<ThreadRing>& ring : registry) {
+            if (!ring->inUse) {
+                ring->inUse = true;
+                ring->threadName.clear();
+                localRing.ring = ring;
+                return *ring;
+            }
+        }
+        localRing.ring = std::make_shared<ThreadRing>();
+        localRing.ring->threadId = static_cast<int>(registry.size()) + 1;
+        registry.push_back(localRing.ring);
+    }
+    return *localRing.ring;
+}
+
+void writeJsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') out << '\\' << *c;
+        else if (static_cast<unsigned char>(*c) >= 0x20) out << *c;
+    }
+    out << '"';
+}
+
+// Trace timestamps are microseconds; keep the nanoseconds as three decimals.
+void writeMicros(std::ostream& out, uint64_t ns) {
+    char digits[4] = {
+        char('0' + ns % 1000 / 100), char('0' + ns % 100 / 10), char('0' + ns % 10), '\0'
+    };
+    out << ns / 1000 << '.' << digits;
+}
+
+} // namespace
+
+std::atomic<int> Profiler::level{Profiler::OFF};
+
+void Profiler::setLevel(Level value) {
+    level.store(value, std::memory_order_relaxed);
+}
+
+uint64_t Profiler::now() {
+    // +1 keeps 0 free to mean "not recording" in ProfileZone.
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch).count()) + 1;
+}
+
+void Profiler::record(const char* name, uint64_t beginNs, uint64_t endNs) {
+    ThreadRing& ring = threadRing();
+    uint64_t index = ring.head.load(std::memory_order_relaxed);
+    Event& event = ring.events[index & (RING_CAPACITY - 1)];
+    event.name.store(name, std::memory_order_relaxed);
+    event.beginNs.store(beginNs, std::memory_order_relaxed);
+    event.endNs.store(endNs, std::memory_order_relaxed);
+    ring.head.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    if (!isRecording(ZONES)) return;
+    ThreadRing& ring = threadRing();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    ring.threadName = name;
+}
+
+void Profiler::exportChromeTrace(std::ostream& out) {
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        rings = registry;
+    }
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) out << ",";
+        out << "\n";
+        first = false;
+    };
+
+    struct Copy {
+        const char* name;
+        uint64_t beginNs;
+        uint64_t endNs;
+    };
+    std::vector<Copy> events;
+    events.reserve(RING_CAPACITY);
+    for (const std::shared_ptr<ThreadRing>& ring : rings) {
+        std::string threadName;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            threadName = ring->threadName;
+        }
+        if (threadName.empty()) threadName = "thread " + std::to_string(ring->threadId);
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->threadId << ",\"args\":{\"name\":";
+        writeJsonString(out, threadName.c_str());
+        out << "}}";
+
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t begin = std::max(ring->start.load(std::memory_order_relaxed),
+                                  head > RING_CAPACITY ? head - RING_CAPACITY : 0);
+        events.clear();
+        for (uint64_t i = begin; i < head; ++i) {
+            const Event& event = ring->events[i & (RING_CAPACITY - 1)];
+            events.push_back({event.name.load(std::memory_order_relaxed),
+                              event.beginNs.load(std::memory_order_relaxed),
+                              event.endNs.load(std::memory_order_relaxed)});
+        }
+
+        // The owner may have lapped the ring while we copied; slots it has
+        // started to overwrite since are no longer consistent.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = ring->head.load(std::memory_order_relaxed);
+        size_t skip = after >= begin + RING_CAPACITY
+            ? static_cast<size_t>(std::min<uint64_t>(after - RING_CAPACITY + 1 - begin, events.size())) : 0;
+
+        for (size_t i = skip; i < events.size(); ++i) {
+            const Copy& event = events[i];
+            if (!event.name) continue;
+            separator();
+            out << "{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"cat\":\"connect6\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->threadId
+                << ",\"ts\":";
+            writeMicros(out, event.beginNs);
+            out << ",\"dur\":";
+            writeMicros(out, event.endNs - event.beginNs);
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+}
+
+bool Profiler::exportChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) return false;
+    exportChromeTrace(out);
+    return static_cast<bool>(out);
+}
+
+void Profiler::clear() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const std::shared_ptr<ThreadRing>& ring : registry) {
+        ring->start.store(ring->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,252 @@
+#include "core/SparseBoard.h"
+#include <algorithm>
+#include "core/BitBoard.h"
+
+namespace {
+
+const int DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+const int REACH = SparseBoard::WIN_LENGTH - 1;     // cells each side of a stone a window can reach
+const int CANDIDATE_REACH = 2;                     // getCandidates() distance from a stone
+const int8_t OFF_BOARD = -1;
+
+int colorIndex(Player player) {
+    return player == Player::BLACK ? 0 : 1;
+}
+
+Player opponent(Player player) {
+    return player == Player::BLACK ? Player::WHITE : Player::BLACK;
+}
+
+// An 8x8 chunk mask moved `count` columns right (left if negative); cells
+// pushed past the chunk's edge drop off.
+uint64_t shiftCols(uint64_t mask, int count) {
+    const uint64_t COLUMN_0 = 0x0101010101010101ULL;
+    if (count >= SparseBoard::CHUNK_SIZE || count <= -SparseBoard::CHUNK_SIZE) return 0;
+    if (count >= 0) {
+        uint64_t keep = COLUMN_0 * ((0xFFu >> count) & 0xFFu);        // columns that stay inside
+        return (mask & keep) << count;
+    }
+    uint64_t keep = COLUMN_0 * ((0xFFu << -count) & 0xFFu);
+    return (mask & keep) >> -count;
+}
+
+// The same for rows, moving down (up if negative).
+uint64_t shiftRows(uint64_t mask, int count) {
+    if (count >= SparseBoard::CHUNK_SIZE || count <= -SparseBoard::CHUNK_SIZE) return 0;
+    return count >= 0 ? mask << (count * SparseBoard::CHUNK_SIZE) : mask >> (-count * SparseBoard::CHUNK_SIZE);
+}
+
+} // namespace
+
+const int64_t SparseBoard::WINDOW_SCORES[WIN_LENGTH + 1] = {0, 1, 10, 100, 1000, 10000, 1000000};
+
+SparseBoard::SparseBoard(int size)
+    : size(std::max(0, size)) {
+    reset();
+}
+
+int SparseBoard::getSize() const {
+    return size;
+}
+
+bool SparseBoard::isOnBoard(int row, int col) const {
+    return size == UNBOUNDED || (row >= 0 && row < size && col >= 0 && col < size);
+}
+
+Player SparseBoard::getCell(int row, int col) const {
+    auto chunk = chunks.find(chunkKey(row, col));
+    if (chunk == chunks.end()) return Player::NONE;
+    uint64_t bit = uint64_t(1) << ((row & (CHUNK_SIZE - 1)) * CHUNK_SIZE + (col & (CHUNK_SIZE - 1)));
+    if (chunk->second.stones[0] & bit) return Player::BLACK;
+    if (chunk->second.stones[1] & bit) return Player::WHITE;
+    return Player::NONE;
+}
+
+Player SparseBoard::getCurrentPlayer() const {
+    return currentPlayer;
+}
+
+GameState SparseBoard::getGameState() const {
+    return gameState;
+}
+
+int SparseBoard::getMoveCount() const {
+    return static_cast<int>(moves.size());
+}
+
+const std::vector<std::pair<int, int>>& SparseBoard::getMoves() const {
+    return moves;
+}
+
+uint64_t SparseBoard::getHash() const {
+    return hash;
+}
+
+size_t SparseBoard::getChunkCount() const {
+    return chunks.size();
+}
+
+bool SparseBoard::makeMove(int row, int col) {
+    if (gameState != GameState::IN_PROGRESS || !isOnBoard(row, col) || getCell(row, col) != Player::NONE) {
+        return false;
+    }
+    Player player = currentPlayer;
+    updateWindows(row, col, player, 1);
+    Chunk& chunk = chunks[chunkKey(row, col)];
+    chunk.stones[colorIndex(player)] |= uint64_t(1) << ((row & (CHUNK_SIZE - 1)) * CHUNK_SIZE + (col & (CHUNK_SIZE - 1)));
+    moves.emplace_back(row, col);
+    hash ^= stoneKey(row, col, player);
+
+    if (makesSix(row, col, player)) {
+        gameState = player == Player::BLACK ? GameState::BLACK_WIN : GameState::WHITE_WIN;
+    } else if (size != UNBOUNDED && moves.size() == static_cast<size_t>(size) * size) {
+        gameState = GameState::DRAW;
+    }
+    currentPlayer = opponent(player);
+    return true;
+}
+
+void SparseBoard::undoMove() {
+    if (moves.empty()) return;
+    auto [row, col] = moves.back();
+    moves.pop_back();
+    Player player = opponent(currentPlayer);
+    auto chunk = chunks.find(chunkKey(row, col));
+    chunk->second.stones[colorIndex(player)] &=
+        ~(uint64_t(1) << ((row & (CHUNK_SIZE - 1)) * CHUNK_SIZE + (col & (CHUNK_SIZE - 1))));
+    if ((chunk->second.stones[0] | chunk->second.stones[1]) == 0) chunks.erase(chunk);
+    updateWindows(row, col, player, -1);
+    hash ^= stoneKey(row, col, player);
+    currentPlayer = player;
+    gameState = GameState::IN_PROGRESS;
+}
+
+void SparseBoard::reset() {
+    chunks.clear();
+    moves.clear();
+    currentPlayer = Player::BLACK;
+    gameState = GameState::IN_PROGRESS;
+    hash = 0;
+    windowScores[0] = windowScores[1] = 0;
+}
+
+void SparseBoard::getCandidates(std::vector<std::pair<int, int>>& cells) const {
+    cells.clear();
+    if (moves.empty()) {
+        cells.emplace_back(size / 2, size / 2);
+        return;
+    }
+    // Spread each chunk's stones two cells in every direction, as masks over
+    // the chunk and its eight neighbours, then take the empty cells.
+    std::vector<std::pair<uint64_t, uint64_t>> near;
+    for (const auto& [key, chunk] : chunks) {
+        int chunkRow = static_cast<int32_t>(key >> 32);
+        int chunkCol = static_cast<int32_t>(key);
+        uint64_t stones = chunk.stones[0] | chunk.stones[1];
+        for (int dCol = -1; dCol <= 1; ++dCol) {
+            uint64_t wide = 0;
+            for (int step = -CANDIDATE_REACH; step <= CANDIDATE_REACH; ++step) {
+                wide |= shiftCols(stones, step - dCol * CHUNK_SIZE);
+            }
+            if (!wide) continue;
+            for (int dRow = -1; dRow <= 1; ++dRow) {
+                uint64_t mask = 0;
+                for (int step = -CANDIDATE_REACH; step <= CANDIDATE_REACH; ++step) {
+                    mask |= shiftRows(wide, step - dRow * CHUNK_SIZE);
+                }
+                if (mask) near.emplace_back(chunkKeyOf(chunkRow + dRow, chunkCol + dCol), mask);
+            }
+        }
+    }
+    std::sort(near.begin(), near.end());
+    for (size_t i = 0; i < near.size();) {
+        uint64_t key = near[i].first;
+        uint64_t mask = 0;
+        for (; i < near.size() && near[i].first == key; ++i) mask |= near[i].second;
+        auto chunk = chunks.find(key);
+        if (chunk != chunks.end()) mask &= ~(chunk->second.stones[0] | chunk->second.stones[1]);
+        int baseRow = static_cast<int32_t>(key >> 32) * CHUNK_SIZE;
+        int baseCol = static_cast<int32_t>(key) * CHUNK_SIZE;
+        for (; mask; mask &= mask - 1) {
+            int bit = lowestBit64(mask);
+            int row = baseRow + bit / CHUNK_SIZE;
+            int col = baseCol + bit % CHUNK_SIZE;
+            if (isOnBoard(row, col)) cells.emplace_back(row, col);
+        }
+    }
+    std::sort(cells.begin(), cells.end());
+}
+
+int64_t SparseBoard::evaluate(Player player) const {
+    int own = colorIndex(player);
+    return windowScores[own] - windowScores[1 - own];
+}
+
+uint64_t SparseBoard::chunkKey(int row, int col) {
+    // Arithmetic shifts round toward minus infinity, so negative coordinates
+    // of an unbounded board get chunks of their own.
+    return chunkKeyOf(row >> CHUNK_BITS, col >> CHUNK_BITS);
+}
+
+uint64_t SparseBoard::chunkKeyOf(int chunkRow, int chunkCol) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(chunkRow)) << 32 | static_cast<uint32_t>(chunkCol);
+}
+
+uint64_t SparseBoard::stoneKey(int row, int col, Player player) {
+    // splitmix64 finalizer over the cell and colour
+    uint64_t z = (static_cast<uint64_t>(static_cast<uint32_t>(row)) << 32 | static_cast<uint32_t>(col)) * 2 +
+                 colorIndex(player) + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void SparseBoard::updateWindows(int row, int col, Player player, int sign) {
+    int own = colorIndex(player);
+    for (const auto& direction : DIRECTIONS) {
+        // The line through the cell, REACH cells each side; the cell itself is empty.
+        int8_t line[2 * REACH + 1];
+        for (int i = -REACH; i <= REACH; ++i) {
+            int r = row + i * direction[0];
+            int c = col + i * direction[1];
+            if (!isOnBoard(r, c)) line[i + REACH] = OFF_BOARD;
+            else line[i + REACH] = static_cast<int8_t>(i == 0 ? Player::NONE : getCell(r, c));
+        }
+        for (int start = 0; start + WIN_LENGTH <= 2 * REACH + 1; ++start) {
+            int counts[3] = {0, 0, 0};
+            bool onBoard = true;
+            for (int i = start; i < start + WIN_LENGTH; ++i) {
+                if (line[i] == OFF_BOARD) {
+                    onBoard = false;
+                    break;
+                }
+                counts[line[i]]++;
+            }
+            if (!onBoard) continue;
+            int ownStones = counts[static_cast<int>(player)];
+            int otherStones = counts[static_cast<int>(opponent(player))];
+            if (otherStones == 0) {
+                windowScores[own] += sign * (WINDOW_SCORES[ownStones + 1] - WINDOW_SCORES[ownStones]);
+            } else if (ownStones == 0) {
+                windowScores[1 - own] -= sign * WINDOW_SCORES[otherStones];
+            }
+        }
+    }
+}
+
+bool SparseBoard::makesSix(int row, int col, Player player) const {
+    for (const auto& direction : DIRECTIONS) {
+        int count = 1;
+        for (int side = -1; side <= 1; side += 2) {
+            int r = row + side * direction[0];
+            int c = col + side * direction[1];
+            while (count < WIN_LENGTH && getCell(r, c) == player) {
+                count++;
+                r += side * direction[0];
+                c += side * direction[1];
+            }
+        }
+        if (count >= WIN_LENGTH) return true;
+    }
+    return false;
+}
@@ -0,0 +1,82 @@
+#include "gui/AnalysisOverlay.h"
+#include "core/Metrics.h"
+#include "core/Profiler.h"
+#include <QEvent>
+#include <QGridLayout>
+#include <QPainter>
+#include <algorithm>
+
+AnalysisOverlay::AnalysisOverlay(QGridLayout* grid, QWidget* parent)
+    : QWidget(parent)
+    , grid(grid) {
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_NoSystemBackground);
+    setGeometry(parent->rect());
+    parent->installEventFilter(this);
+    raise();
+}
+
+void AnalysisOverlay::setAnalysis(const AnalysisInfo& info) {
+    analysis = info;
+    update();
+}
+
+void AnalysisOverlay::clear() {
+    analysis = AnalysisInfo();
+    update();
+}
+
+bool AnalysisOverlay::eventFilter(QObject* watched, QEvent* event) {
+    if (watched == parentWidget() && event->type() == QEvent::Resize) {
+        setGeometry(parentWidget()->rect());
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void AnalysisOverlay::paintEvent(QPaintEvent*) {
+    PROFILE_ZONE("AnalysisOverlay::paint");
+    static MetricHistogram& paintTime = MetricsRegistry::global().histogram(
+        "connect6_ui_overlay_paint_seconds", "Time to paint the analysis overlay",
+        MetricsRegistry::latencyBuckets());
+    MetricTimer timer(paintTime);
+    if (analysis.rootMoves.empty()) return;
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    // Colors run from blue (worst) to red (best) over the moves' score range;
+    // won and lost lines are clamped so they do not flatten everything else.
+    const int limit = 1000000;
+    int best = -limit;
+    int worst = limit;
+    for (const ScoredMove& entry : analysis.rootMoves) {
+        int score = std::max(-limit, std::min(limit, entry.score));
+        best = std::max(best, score);
+        worst = std::min(worst, score);
+    }
+    double range = std::max(1, best - worst);
+
+    painter.setPen(Qt::NoPen);
+    for (const ScoredMove& entry : analysis.rootMoves) {
+        double t = (std::max(-limit, std::min(limit, entry.score)) - worst) / range;
+        QColor color(static_cast<int>(255 * t), 60, static_cast<int>(255 * (1 - t)), 40 + static_cast<int>(110 * t));
+        QRect cell = grid->cellRect(entry.move.first, entry.move.second);
+        painter.setBrush(color);
+        painter.drawEllipse(cell.adjusted(3, 3, -3, -3));
+    }
+
+    QFont font = painter.font();
+    font.setBold(true);
+    painter.setFont(font);
+    painter.setPen(Qt::black);
+    for (size_t i = 0; i < analysis.pv.size(); ++i) {
+        QRect cell = grid->cellRect(analysis.pv[i].first, analysis.pv[i].second);
+        painter.drawText(cell, Qt::AlignCenter, QString::number(i + 1));
+    }
+
+    QString status = QString("Depth %1  %2/%3").arg(analysis.depth).arg(analysis.searchedMoves).arg(analysis.totalMoves);
+    if (!analysis.bestMoves.empty()) status += QString("  Best %1").arg(analysis.bestMoves.front().score);
+    QRect textRect = rect().adjusted(6, 4, -6, -4);
+    painter.setPen(QColor(44, 62, 80));
+    painter.drawText(textRect, Qt::AlignTop | Qt::AlignRight, status);
+}
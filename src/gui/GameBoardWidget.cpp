@@ -1,7 +1,12 @@
 #include "gui/GameBoardWidget.h"
+#include "gui/AnalysisOverlay.h"
+#include "core/Metrics.h"
+#include "core/Profiler.h"
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QTimer>
+#include <QSlider>
+#include <QSignalBlocker>
 #include <QPropertyAnimation>
 #include <QGraphicsDropShadowEffect>
 #include <QPainter>
@@ -12,15 +17,29 @@ GameBoardWidget::GameBoardWidget(GameBoard* board, QWidget* parent)
     , board(board)
     , ai(new GameAI())
     , ai2(new GameAI())
+    , ponder(new PonderSearch(*ai))
+    , hints(new HintService())
+    , search(new BackgroundSearch())
+    , searchGeneration(0)
+    , analysisOverlay(nullptr)
+    , analysisTimer(nullptr)
+    , aiMoveTimer(nullptr)
     , gameMode(0)
     , humanPlayer(Player::BLACK)
-    , hintCell(nullptr) {
+    , hintCell(nullptr)
+    , timelineSlider(nullptr)
+    , timelineLabel(nullptr) {
+    hints->setChannel(&analysisChannel);
     setupUI();
     setupConnections();
     updateBoard();
 }
 
 GameBoardWidget::~GameBoardWidget() {
+    analysisTimer->stop();
+    delete search;
+    delete hints;
+    delete ponder;
     delete ai;
     delete ai2;
 }
@@ -166,6 +185,8 @@ void GameBoardWidget::setupUI() {
     menuButton = new QPushButton("Menu");
     pauseButton = new QPushButton("Pause");
     pauseButton->setCheckable(true);
+    analyzeButton = new QPushButton("Analyze");
+    analyzeButton->setCheckable(true);
 
     undoButton->setStyleSheet(buttonStyle);
     hintButton->setStyleSheet(buttonStyle);
@@ -174,9 +195,11 @@ void GameBoardWidget::setupUI() {
     resetButton->setStyleSheet(buttonStyle);
     menuButton->setStyleSheet(buttonStyle);
     pauseButton->setStyleSheet(buttonStyle);
+    analyzeButton->setStyleSheet(buttonStyle);
 
     controlLayout->addWidget(undoButton);
     controlLayout->addWidget(hintButton);
+    controlLayout->addWidget(analyzeButton);
     controlLayout->addWidget(saveButton);
     controlLayout->addWidget(loadButton);
     controlLayout->addWidget(resetButton);
@@ -185,7 +208,7 @@ void GameBoardWidget::setupUI() {
 
     mainLayout->addWidget(controlPanel);
 
-    QWidget* boardContainer = new QWidget();
+    boardContainer = new QWidget();
     boardContainer->setStyleSheet("background-color: #f5d76e; border-radius: 4px; padding: 4px;");
     boardContainer->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     QVBoxLayout* containerLayout = new QVBoxLayout(boardContainer);
@@ -231,6 +254,31 @@ void GameBoardWidget::setupUI() {
     containerLayout->addLayout(gridLayout);
     mainLayout->addWidget(boardContainer, 1);
 
+    // Timeline scrubber: drag to any earlier position of the game and back
+    QWidget* timelinePanel = new QWidget();
+    timelinePanel->setStyleSheet("background-color: #34495e; border-radius: 4px; padding: 4px;");
+    QHBoxLayout* timelineLayout = new QHBoxLayout(timelinePanel);
+    timelineLayout->setSpacing(10);
+    timelineLayout->setContentsMargins(5, 5, 5, 5);
+
+    timelineSlider = new QSlider(Qt::Horizontal);
+    timelineSlider->setRange(0, 0);
+    timelineSlider->setPageStep(GameTimeline::SNAPSHOT_INTERVAL);
+    timelineLayout->addWidget(timelineSlider, 1);
+
+    timelineLabel = new QLabel();
+    timelineLabel->setStyleSheet("color: white; font-size: 11px; font-weight: bold;");
+    timelineLayout->addWidget(timelineLabel);
+    mainLayout->addWidget(timelinePanel);
+
+    // Created after the cells so it stacks above them
+    analysisOverlay = new AnalysisOverlay(gridLayout, boardContainer);
+    analysisOverlay->hide();
+    analysisTimer = new QTimer(this);
+    analysisTimer->setInterval(1000 / ANALYSIS_UPDATES_PER_SECOND);
+    aiMoveTimer = new QTimer(this);
+    aiMoveTimer->setSingleShot(true);
+
     setStyleSheet("QWidget {"
                   "    background-color: #ecf0f1;"
                   "}");
@@ -256,18 +304,29 @@ void GameBoardWidget::setupConnections() {
     connect(resetButton, &QPushButton::clicked, this, &GameBoardWidget::resetGame);
     connect(menuButton, &QPushButton::clicked, this, &GameBoardWidget::onMenuClicked);
     connect(pauseButton, &QPushButton::clicked, this, &GameBoardWidget::onPauseClicked);
+    connect(analyzeButton, &QPushButton::toggled, this, &GameBoardWidget::onAnalyzeToggled);
+    connect(analysisTimer, &QTimer::timeout, this, &GameBoardWidget::pollAnalysis);
+    connect(aiMoveTimer, &QTimer::timeout, this, &GameBoardWidget::makeAIMove);
+    connect(timelineSlider, &QSlider::valueChanged, this, &GameBoardWidget::onTimelineMoved);
 }
 
 void GameBoardWidget::onDifficultyChanged(int index) {
+    // A search running at the old difficulty starts over at the new one.
+    bool searching = search->isActive();
+    cancelSearches();
     AIDifficulty difficulty = static_cast<AIDifficulty>(difficultyComboBox->itemData(index).toInt());
     ai->setDifficulty(difficulty);
     updateStatus();
+    if (searching) scheduleAIMove(0);
 }
 
 void GameBoardWidget::onAIDifficultyChanged(int index) {
+    bool searching = search->isActive();
+    cancelSearches();
     AIDifficulty difficulty = static_cast<AIDifficulty>(ai2DifficultyComboBox->itemData(index).toInt());
     ai2->setDifficulty(difficulty);
     updateStatus();
+    if (searching) scheduleAIMove(0);
 }
 
 void GameBoardWidget::setAIDifficulty(AIDifficulty difficulty) {
@@ -277,41 +336,135 @@ void GameBoardWidget::setAIDifficulty(AIDifficulty difficulty) {
     }
 }
 
+void GameBoardWidget::setAIEngine(AIEngine engine) {
+    cancelSearches();
+    ai->setEngine(engine);
+    ai2->setEngine(engine);
+    updateStatus();
+}
+
 void GameBoardWidget::updateBoard() {
-    for (int row = 0; row < 15; ++row) {
-        for (int col = 0; col < 15; ++col) {
-            QPushButton* cell = qobject_cast<QPushButton*>(gridLayout->itemAtPosition(row, col)->widget());
-            Player player = board->getCell(row, col);
-            
-            QString style = "QPushButton {"
-                          "    border: 1px solid #ccc;"
-                          "    border-radius: 50%;"
-                          "}";
-            
-            if (player == Player::BLACK) {
-                style += "QPushButton {"
-                        "    background-color: #2c3e50;"
-                        "    border: 1px solid #1a252f;"
-                        "}";
-            } else if (player == Player::WHITE) {
-                style += "QPushButton {"
-                        "    background-color: #e74c3c;"
-                        "    border: 1px solid #c0392b;"
-                        "}";
-            } else {
-                style += "QPushButton {"
-                        "    background-color: #f0f0f0;"
-                        "}";
-            }
-            
-            cell->setStyleSheet(style);
+    PROFILE_ZONE("updateBoard");
+    static MetricHistogram& updateTime = MetricsRegistry::global().histogram(
+        "connect6_ui_board_update_seconds", "Time to restyle the board after a move",
+        MetricsRegistry::latencyBuckets());
+    MetricTimer timer(updateTime);
+    for (int row = 0; row < GameBoard::BOARD_SIZE; ++row) {
+        for (int col = 0; col < GameBoard::BOARD_SIZE; ++col) {
+            restyleCell(row, col);
+        }
+    }
+    updateStatus();
+    refreshHints();
+    syncTimeline();
+}
+
+void GameBoardWidget::restyleCell(int row, int col) {
+    QPushButton* cell = qobject_cast<QPushButton*>(gridLayout->itemAtPosition(row, col)->widget());
+    Player player = board->getCell(row, col);
+
+    QString style = "QPushButton {"
+                  "    border: 1px solid #ccc;"
+                  "    border-radius: 50%;"
+                  "}";
+
+    if (player == Player::BLACK) {
+        style += "QPushButton {"
+                "    background-color: #2c3e50;"
+                "    border: 1px solid #1a252f;"
+                "}";
+    } else if (player == Player::WHITE) {
+        style += "QPushButton {"
+                "    background-color: #e74c3c;"
+                "    border: 1px solid #c0392b;"
+                "}";
+    } else {
+        style += "QPushButton {"
+                "    background-color: #f0f0f0;"
+                "}";
+    }
+
+    cell->setStyleSheet(style);
+    shownCells[row][col] = player;
+}
+
+void GameBoardWidget::syncTimeline() {
+    timeline.sync(*board);
+    QSignalBlocker blocker(timelineSlider);
+    timelineSlider->setRange(0, timeline.size());
+    timelineSlider->setValue(board->getMoveCount());
+    timelineLabel->setText(QString("Move %1 / %2").arg(board->getMoveCount()).arg(timeline.size()));
+}
+
+void GameBoardWidget::onTimelineMoved(int ply) {
+    PROFILE_ZONE("onTimelineMoved");
+    if (ply == board->getMoveCount()) return;
+    cancelSearches();
+    aiMoveTimer->stop();
+
+    // Take down the winning line of a finished position before leaving it.
+    std::vector<std::pair<int, int>> shownLine;
+    if (board->getGameState() != GameState::IN_PROGRESS) shownLine = board->getWinningLine();
+    timeline.seek(*board, ply);
+    for (const auto& [row, col] : shownLine) {
+        gridLayout->itemAtPosition(row, col)->widget()->setGraphicsEffect(nullptr);
+        restyleCell(row, col);
+    }
+
+    // Restyling is what a seek costs here, so only the cells that changed are.
+    for (int row = 0; row < GameBoard::BOARD_SIZE; ++row) {
+        for (int col = 0; col < GameBoard::BOARD_SIZE; ++col) {
+            if (board->getCell(row, col) != shownCells[row][col]) restyleCell(row, col);
         }
     }
     updateStatus();
+    refreshHints();
+    syncTimeline();
+    if (board->getGameState() != GameState::IN_PROGRESS) highlightWinningLine();
+
+    // Only a move played here drops the rest of the game, so an AI to move
+    // waits for Resume instead of playing over it.
+    if (isAIToMove()) {
+        pauseButton->setChecked(true);
+    } else if (gameMode == 1 && board->getGameState() == GameState::IN_PROGRESS) {
+        ponder->start(*board, humanPlayer);
+    }
+}
+
+void GameBoardWidget::refreshHints() {
+    // The hint engine analyses the human's positions. While an AI is to move
+    // its own search feeds the analysis view, and a second search beside it
+    // would only slow it down.
+    bool humanToMove = gameMode == 0 || (gameMode == 1 && board->getCurrentPlayer() == humanPlayer);
+    if (board->getGameState() == GameState::IN_PROGRESS && humanToMove) {
+        hints->analyze(*board);
+    } else {
+        hints->stop();
+        if (!search->isActive()) analysisChannel.clear();
+    }
+}
+
+void GameBoardWidget::onAnalyzeToggled(bool enabled) {
+    if (enabled) {
+        analysisOverlay->setGeometry(boardContainer->rect());
+        analysisOverlay->show();
+        analysisOverlay->raise();
+        analysisTimer->start();
+    } else {
+        analysisTimer->stop();
+        analysisOverlay->clear();
+        analysisOverlay->hide();
+    }
+    refreshHints();
+}
+
+void GameBoardWidget::pollAnalysis() {
+    AnalysisInfo info;
+    if (analysisChannel.take(info)) analysisOverlay->setAnalysis(info);
 }
 
 void GameBoardWidget::handleCellClicked(int row, int col) {
-    if (board->getGameState() != GameState::IN_PROGRESS) return;
+    if (board->getGameState() != GameState::IN_PROGRESS || search->isActive()) return;
     
     Player current = board->getCurrentPlayer();
     if (gameMode == 1 && current != humanPlayer) return;
@@ -324,15 +477,28 @@ void GameBoardWidget::handleCellClicked(int row, int col) {
         animation->setEndValue(QRect(cell->x(), cell->y(), cell->width(), cell->height()));
         animation->setEasingCurve(QEasingCurve::OutBounce);
         
-        connect(animation, &QPropertyAnimation::finished, this, [this]() {
+        connect(animation, &QPropertyAnimation::finished, this, [this, row, col]() {
             updateBoard();
             
             if (board->getGameState() != GameState::IN_PROGRESS) {
+                cancelSearches();
                 highlightWinningLine();
             }
             
             if (board->getGameState() == GameState::IN_PROGRESS && gameMode == 1 && board->getCurrentPlayer() != humanPlayer) {
-                QTimer::singleShot(1000, this, &GameBoardWidget::makeAIMove);
+                // A ponder hit has the answer, or posts it like makeAIMove()'s
+                // search when it ends; otherwise search now.
+                const int generation = ++searchGeneration;
+                std::pair<int, int> reply;
+                bool hit = ponder->finish({row, col}, reply, [this, generation](std::pair<int, int> move) {
+                    QMetaObject::invokeMethod(this, [this, generation, move]() { onAIMoveFound(generation, move); },
+                                              Qt::QueuedConnection);
+                });
+                if (!hit) {
+                    scheduleAIMove(0);
+                } else if (reply.first >= 0) {
+                    onAIMoveFound(generation, reply);
+                }
             }
         });
         
@@ -341,6 +507,7 @@ void GameBoardWidget::handleCellClicked(int row, int col) {
 }
 
 void GameBoardWidget::undoMove() {
+    cancelSearches();
     board->undoLastMove();
     updateBoard();
 }
@@ -351,10 +518,14 @@ void GameBoardWidget::getHint() {
     Player current = board->getCurrentPlayer();
     if (gameMode == 1 && current != humanPlayer) return;
     
-    AIDifficulty currentDifficulty = ai->getDifficulty();
-    ai->setDifficulty(AIDifficulty::HARD);
-    auto [row, col] = ai->getBestMove(*board, current);
-    ai->setDifficulty(currentDifficulty);
+    // Answered from the background analysis; right after a move it may
+    // still be on its first pass, so give it at most one frame.
+    Hint hint;
+    if (!hints->getHint(*board, hint, std::chrono::milliseconds(16))) {
+        hints->analyze(*board);
+        return;
+    }
+    auto [row, col] = hint.moves.front().move;
     
     if (hintCell) {
         QString currentStyle = hintCell->styleSheet();
@@ -362,6 +533,7 @@ void GameBoardWidget::getHint() {
         currentStyle = currentStyle.replace("background-color: #e3f2fd;", "");
         currentStyle = currentStyle.replace("box-shadow: 0 0 10px #3498db;", "");
         hintCell->setStyleSheet(currentStyle);
+        hintCell->setToolTip(QString());
         
         QGraphicsDropShadowEffect* oldEffect = qobject_cast<QGraphicsDropShadowEffect*>(hintCell->graphicsEffect());
         if (oldEffect) {
@@ -372,6 +544,13 @@ void GameBoardWidget::getHint() {
     
     hintCell = qobject_cast<QPushButton*>(gridLayout->itemAtPosition(row, col)->widget());
     
+    QString candidates = hint.depth > 0 ? QString("Depth %1%2").arg(hint.depth).arg(hint.final ? "" : ", still searching")
+                                        : QString("Searching...");
+    for (const ScoredMove& candidate : hint.moves) {
+        candidates += QString("\n(%1, %2): %3").arg(candidate.move.first).arg(candidate.move.second).arg(candidate.score);
+    }
+    hintCell->setToolTip(candidates);
+    
     QGraphicsDropShadowEffect* glowEffect = new QGraphicsDropShadowEffect();
     glowEffect->setBlurRadius(20);
     glowEffect->setColor(QColor(52, 152, 219, 255));
@@ -410,7 +589,11 @@ void GameBoardWidget::saveGame() {
 void GameBoardWidget::loadGame() {
     QString fileName = QFileDialog::getOpenFileName(this, "Load Game", "", "Game Files (*.game)");
     if (!fileName.isEmpty()) {
+        cancelSearches();
         if (board->loadGame(fileName.toStdString())) {
+            ai->newGame();
+            ai2->newGame();
+            timeline.clear();
             updateBoard();
         } else {
             QMessageBox::warning(this, "Error", "Failed to load game");
@@ -419,6 +602,7 @@ void GameBoardWidget::loadGame() {
 }
 
 void GameBoardWidget::resetGame() {
+    cancelSearches();
     QList<QPropertyAnimation*> animations = findChildren<QPropertyAnimation*>();
     for (QPropertyAnimation* animation : animations) {
         animation->stop();
@@ -426,6 +610,9 @@ void GameBoardWidget::resetGame() {
     }
 
     board->reset();
+    ai->newGame();
+    ai2->newGame();
+    timeline.clear();
     for (int row = 0; row < GameBoard::BOARD_SIZE; ++row) {
         for (int col = 0; col < GameBoard::BOARD_SIZE; ++col) {
             QPushButton* cell = qobject_cast<QPushButton*>(gridLayout->itemAtPosition(row, col)->widget());
@@ -442,7 +629,7 @@ void GameBoardWidget::resetGame() {
     updateBoard();
     
     if (gameMode == 2) {
-        QTimer::singleShot(500, this, &GameBoardWidget::makeAIMove);
+        scheduleAIMove(500);
     }
 }
 
@@ -468,6 +655,9 @@ void GameBoardWidget::updateStatus() {
     } else {
         difficultyText = "Difficulty: " + difficultyComboBox->currentText();
     }
+    if (ai->getEngine() == AIEngine::MCTS) {
+        difficultyText += " | Engine: MCTS";
+    }
     difficultyLabel->setText(difficultyText);
 
     QString currentPlayerText;
@@ -493,15 +683,48 @@ void GameBoardWidget::updateStatus() {
 }
 
 void GameBoardWidget::makeAIMove() {
-    if (board->getGameState() != GameState::IN_PROGRESS || pauseButton->isChecked()) return;
+    if (board->getGameState() != GameState::IN_PROGRESS || pauseButton->isChecked() || search->isActive()) return;
     
     Player current = board->getCurrentPlayer();
     if (gameMode == 1 && current == humanPlayer) return;
     
     GameAI* currentAI = (gameMode == 2 && current == Player::WHITE) ? ai2 : ai;
-    auto [row, col] = currentAI->getBestMove(*board, current);
-    
+    ponder->cancel();
+    hints->stop();
+    // The move comes back through the event loop; a search cancelled since
+    // it was started is recognised by its generation and ignored.
+    const int generation = ++searchGeneration;
+    search->start(*currentAI, *board, &analysisChannel, [this, generation](std::pair<int, int> move) {
+        QMetaObject::invokeMethod(this, [this, generation, move]() { onAIMoveFound(generation, move); },
+                                  Qt::QueuedConnection);
+    });
+}
+
+void GameBoardWidget::onAIMoveFound(int generation, std::pair<int, int> move) {
+    if (generation != searchGeneration) return;
+    // Joins the finished thread, whichever of the two searched.
+    search->cancel();
+    ponder->cancel();
+    if (board->isValidMove(move.first, move.second)) {
+        playAIMove(move.first, move.second);
+    } else {
+        scheduleAIMove(0);
+    }
+}
+
+void GameBoardWidget::cancelSearches() {
+    ponder->cancel();
+    search->cancel();
+    ++searchGeneration;
+}
+
+void GameBoardWidget::playAIMove(int row, int col) {
+    Player current = board->getCurrentPlayer();
     if (board->makeMove(row, col, current)) {
+        if (gameMode == 1 && board->getGameState() == GameState::IN_PROGRESS) {
+            ponder->start(*board, humanPlayer);
+        }
+        
         QPushButton* cell = qobject_cast<QPushButton*>(gridLayout->itemAtPosition(row, col)->widget());
         QPropertyAnimation* animation = new QPropertyAnimation(cell, "geometry");
         animation->setDuration(300);
@@ -517,7 +740,7 @@ void GameBoardWidget::makeAIMove() {
             }
             
             if (board->getGameState() == GameState::IN_PROGRESS && gameMode == 2 && !pauseButton->isChecked()) {
-                QTimer::singleShot(1000, this, &GameBoardWidget::makeAIMove);
+                scheduleAIMove(1000);
             }
         });
         
@@ -526,7 +749,8 @@ void GameBoardWidget::makeAIMove() {
 }
 
 void GameBoardWidget::highlightWinningLine() {
-    auto winningLine = board->getWinningLine();
+    PROFILE_ZONE("highlightWinningLine");
+    const auto& winningLine = board->getWinningLine();
     if (winningLine.empty()) return;
 
     QString winningStyle = "QPushButton {"
@@ -555,6 +779,10 @@ void GameBoardWidget::highlightWinningLine() {
 }
 
 void GameBoardWidget::setGameMode(int mode) {
+    cancelSearches();
+    ai->newGame();
+    ai2->newGame();
+    timeline.clear();
     gameMode = mode;
     if (mode == 2) {
         QLabel* blackLabel = findChild<QLabel*>("Black AI:");
@@ -566,7 +794,7 @@ void GameBoardWidget::setGameMode(int mode) {
         ai2DifficultyComboBox->setCurrentIndex(difficultyComboBox->currentIndex());
         board->reset();
         updateBoard();
-        QTimer::singleShot(500, this, &GameBoardWidget::makeAIMove);
+        scheduleAIMove(500);
     } else {
         QLabel* blackLabel = findChild<QLabel*>("Black AI:");
         QLabel* redLabel = findChild<QLabel*>("Red AI:");
@@ -581,17 +809,30 @@ void GameBoardWidget::setGameMode(int mode) {
 }
 
 void GameBoardWidget::setHumanPlayer(Player player) {
+    cancelSearches();
     humanPlayer = player;
     updateStatus();
 }
 
 void GameBoardWidget::onMenuClicked() {
+    cancelSearches();
+    aiMoveTimer->stop();
     board->reset();
+    timeline.clear();
     emit returnToMainMenu();
 }
 
 void GameBoardWidget::onPauseClicked() {
-    if (!pauseButton->isChecked() && gameMode == 2 && board->getGameState() == GameState::IN_PROGRESS) {
-        QTimer::singleShot(500, this, &GameBoardWidget::makeAIMove);
+    if (!pauseButton->isChecked() && isAIToMove()) {
+        scheduleAIMove(500);
     }
+}
+
+void GameBoardWidget::scheduleAIMove(int delayMs) {
+    aiMoveTimer->start(delayMs);
+}
+
+bool GameBoardWidget::isAIToMove() const {
+    return board->getGameState() == GameState::IN_PROGRESS
+        && (gameMode == 2 || (gameMode == 1 && board->getCurrentPlayer() != humanPlayer));
 } 
\ No newline at end of file
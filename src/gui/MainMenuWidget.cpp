@@ -10,6 +10,7 @@ MainMenuWidget::MainMenuWidget(QWidget* parent)
     , exitButton(new QPushButton(tr("Exit"), this))
     , gameModeCombo(new QComboBox(this))
     , difficultyCombo(new QComboBox(this))
+    , engineCombo(new QComboBox(this))
     , colorCombo(new QComboBox(this))
     , layout(new QVBoxLayout(this))
 {
@@ -24,6 +25,10 @@ MainMenuWidget::MainMenuWidget(QWidget* parent)
     difficultyCombo->addItem(tr("Hard"), 2);
     difficultyCombo->setCurrentIndex(1); // Default to Medium
 
+    // Setup engine combo
+    engineCombo->addItem(tr("Minimax"), 0);
+    engineCombo->addItem(tr("Monte Carlo (MCTS)"), 1);
+
     // Setup color combo
     colorCombo->addItem(tr("Play as Black"), true);
     colorCombo->addItem(tr("Play as White"), false);
@@ -67,6 +72,7 @@ MainMenuWidget::MainMenuWidget(QWidget* parent)
 
     QLabel* gameModeLabel = new QLabel(tr("Game Mode:"), this);
     QLabel* difficultyLabel = new QLabel(tr("AI Difficulty:"), this);
+    QLabel* engineLabel = new QLabel(tr("AI Engine:"), this);
     QLabel* colorLabel = new QLabel(tr("Player Color:"), this);
 
     // Setup layout
@@ -78,6 +84,9 @@ MainMenuWidget::MainMenuWidget(QWidget* parent)
     layout->addWidget(difficultyLabel);
     layout->addWidget(difficultyCombo);
     layout->addSpacing(10);
+    layout->addWidget(engineLabel);
+    layout->addWidget(engineCombo);
+    layout->addSpacing(10);
     layout->addWidget(colorLabel);
     layout->addWidget(colorCombo);
     layout->addSpacing(20);
@@ -137,11 +146,13 @@ MainMenuWidget::MainMenuWidget(QWidget* parent)
     setStyleSheet(comboStyle + labelStyle);
     colorCombo->setVisible(false);
     connect(gameModeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
-            [difficultyLabel, colorLabel, this](int index)
+            [difficultyLabel, engineLabel, colorLabel, this](int index)
             {
                 bool showDifficulty = (index == 1 || index == 2);
                 difficultyLabel->setVisible(showDifficulty);
                 difficultyCombo->setVisible(showDifficulty);
+                engineLabel->setVisible(showDifficulty);
+                engineCombo->setVisible(showDifficulty);
                 colorLabel->setVisible(index == 0);
                 // colorCombo->setVisible(index == 0);
             });
@@ -153,5 +164,6 @@ void MainMenuWidget::onStartGameClicked() {
     int gameMode = gameModeCombo->currentData().toInt();
     int difficulty = difficultyCombo->isVisible() ? difficultyCombo->currentData().toInt() : 1;
     bool playAsBlack = gameMode == 0 ? colorCombo->currentData().toBool() : true;
-    emit startGameClicked(gameMode, difficulty, playAsBlack);
+    int engine = engineCombo->isVisible() ? engineCombo->currentData().toInt() : 0;
+    emit startGameClicked(gameMode, difficulty, playAsBlack, engine);
 } 
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "gui/MainWindow.h"
 #include "gui/MainMenuWidget.h"
+#include <QEvent>
 #include <QStackedWidget>
+#include <QTimer>
 #include <QVBoxLayout>
 
 const int WINDOW_WIDTH = 800;
@@ -11,21 +13,18 @@ MainWindow::MainWindow(QWidget* parent)
     , stackedWidget(new QStackedWidget(this))
     , mainMenu(new MainMenuWidget(this))
     , gameBoard(new GameBoard)
-    , gameBoardWidget(new GameBoardWidget(gameBoard, this))
+    , gameBoardWidget(nullptr)
 {
     setCentralWidget(stackedWidget);
     
     stackedWidget->addWidget(mainMenu);
-    stackedWidget->addWidget(gameBoardWidget);
-    
     stackedWidget->setCurrentWidget(mainMenu);
+    mainMenu->installEventFilter(this);
     
     connect(mainMenu, &MainMenuWidget::startGameClicked,
             this, &MainWindow::startGame);
     connect(mainMenu, &MainMenuWidget::exitClicked,
             this, &QMainWindow::close);
-    connect(gameBoardWidget, &GameBoardWidget::returnToMainMenu,
-            this, &MainWindow::showMainMenu);
     
     // Set fixed window size
     setFixedSize(WINDOW_WIDTH, WINDOW_HEIGHT);
@@ -36,10 +35,37 @@ MainWindow::~MainWindow() {
     delete gameBoard;
 }
 
-void MainWindow::startGame(int gameMode, int difficulty, bool playAsBlack) {
-    gameBoardWidget->setAIDifficulty(static_cast<AIDifficulty>(difficulty));
-    gameBoardWidget->setGameMode(gameMode);
-    stackedWidget->setCurrentWidget(gameBoardWidget);
+bool MainWindow::eventFilter(QObject* watched, QEvent* event) {
+    if (watched == mainMenu && event->type() == QEvent::Paint) {
+        mainMenu->removeEventFilter(this);
+        // Queued behind this paint, so it runs once the frame is flushed.
+        QTimer::singleShot(0, this, &MainWindow::onFirstFrame);
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
+void MainWindow::onFirstFrame() {
+    emit firstFrame();
+    boardView();
+}
+
+GameBoardWidget* MainWindow::boardView() {
+    if (!gameBoardWidget) {
+        gameBoardWidget = new GameBoardWidget(gameBoard, this);
+        stackedWidget->addWidget(gameBoardWidget);
+        connect(gameBoardWidget, &GameBoardWidget::returnToMainMenu,
+                this, &MainWindow::showMainMenu);
+        emit boardViewReady();
+    }
+    return gameBoardWidget;
+}
+
+void MainWindow::startGame(int gameMode, int difficulty, bool playAsBlack, int engine) {
+    GameBoardWidget* view = boardView();
+    view->setAIDifficulty(static_cast<AIDifficulty>(difficulty));
+    view->setAIEngine(static_cast<AIEngine>(engine));
+    view->setGameMode(gameMode);
+    stackedWidget->setCurrentWidget(view);
 }
 
 void MainWindow::showMainMenu() {
@@ -1,11 +1,178 @@
 #include "gui/MainWindow.h"
+#include "ai/ProofSolver.h"
+#include "ai/NNUEEvaluator.h"
+#include "ai/PatternEvaluator.h"
+#include "core/Metrics.h"
+#include "core/Profiler.h"
+#include "protocol/EngineProtocol.h"
 #include <QApplication>
+#include <QTimer>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace {
+
+// connect_6 --solve <game file> [node budget]
+// Proves the value of a saved position for the side to move.
+int solvePosition(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " --solve <game file> [node budget]" << std::endl;
+        return 2;
+    }
+
+    GameBoard board;
+    if (!board.loadGame(argv[2])) {
+        std::cerr << "failed to load " << argv[2] << std::endl;
+        return 1;
+    }
+
+    ProofSolver solver;
+    if (argc > 3) solver.setNodeBudget(std::strtoull(argv[3], nullptr, 10));
+
+    SolverResult result = solver.solve(board, board.getCurrentPlayer());
+    const char* names[] = {"WIN", "LOSS", "DRAW", "UNKNOWN"};
+    std::cout << names[static_cast<int>(result.result)]
+              << " move " << result.bestMove.first << " " << result.bestMove.second
+              << " nodes " << result.nodes << std::endl;
+    return result.result == ProofResult::UNKNOWN ? 3 : 0;
+}
+
+// connect_6 --protocol
+// Runs the text engine protocol on stdin/stdout (see EngineProtocol.h).
+int runProtocol() {
+    EngineProtocol protocol(std::cin, std::cout);
+    return protocol.run();
+}
+
+// CONNECT6_PROFILE=<file> records PROFILE_ZONE timings (in builds with
+// ENABLE_PROFILING) and writes them as a Chrome trace when the program exits.
+// CONNECT6_PROFILE_DETAIL=1 adds the per-pattern and per-move zones.
+int exportProfile(int status) {
+    if (const char* path = std::getenv("CONNECT6_PROFILE")) {
+        if (!Profiler::exportChromeTrace(path)) std::cerr << "failed to write " << path << std::endl;
+    }
+    return status;
+}
+
+// CONNECT6_METRICS=<file> writes the metrics registry there (JSON for a
+// ".json" name, Prometheus text otherwise) every few seconds and on exit.
+const int METRICS_DUMP_INTERVAL_MS = 5000;
+
+int exportMetrics(int status) {
+    if (const char* path = std::getenv("CONNECT6_METRICS")) {
+        if (!MetricsRegistry::global().dump(path)) std::cerr << "failed to write " << path << std::endl;
+    }
+    return status;
+}
+
+// The protocol front-end has no event loop to time the dump, so this thread
+// writes the metrics while it runs; destroying it stops the thread.
+class MetricsDumpThread {
+public:
+    explicit MetricsDumpThread(const std::string& path)
+        : stopping(false)
+        , worker(&MetricsDumpThread::run, this, path) {
+    }
+
+    ~MetricsDumpThread() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        worker.join();
+    }
+
+private:
+    void run(const std::string& path) {
+        Profiler::setThreadName("metrics");
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!wake.wait_for(lock, std::chrono::milliseconds(METRICS_DUMP_INTERVAL_MS), [this]() { return stopping; })) {
+            MetricsRegistry::global().dump(path);
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping;
+    std::thread worker;
+};
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// connect_6 --startup-benchmark
+// Reports how long after main() the window is built, the main menu's first
+// frame is on screen and the board view is ready, then quits. Runs without
+// a display under QT_QPA_PLATFORM=offscreen.
+void benchmarkStartup(QApplication& app, MainWindow& window, Clock::time_point launched) {
+    std::cout << "main window " << millisecondsSince(launched) << " ms" << std::endl;
+    QObject::connect(&window, &MainWindow::firstFrame, [launched]() {
+        std::cout << "first frame " << millisecondsSince(launched) << " ms" << std::endl;
+    });
+    QObject::connect(&window, &MainWindow::boardViewReady, &app, [&app, launched]() {
+        std::cout << "board view " << millisecondsSince(launched) << " ms" << std::endl;
+        QTimer::singleShot(0, &app, &QCoreApplication::quit);
+    });
+}
+
+} // namespace
 
 int main(int argc, char* argv[]) {
+    const Clock::time_point launched = Clock::now();
+    if (std::getenv("CONNECT6_PROFILE")) {
+        Profiler::setThreadName("main");
+        Profiler::setLevel(std::getenv("CONNECT6_PROFILE_DETAIL") ? Profiler::DETAILED : Profiler::ZONES);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--solve") == 0) {
+        return solvePosition(argc, argv);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--protocol") == 0) {
+        std::unique_ptr<MetricsDumpThread> metricsDump;
+        if (const char* path = std::getenv("CONNECT6_METRICS")) metricsDump.reset(new MetricsDumpThread(path));
+        int status = runProtocol();
+        metricsDump.reset();
+        return exportMetrics(exportProfile(status));
+    }
+
     QApplication app(argc, argv);
+    // Optional tuned or learned evaluation weights shipped next to the executable.
+    std::string appDir = QCoreApplication::applicationDirPath().toStdString();
+    PatternWeights::setDefaultPath(appDir + "/connect6.weights");
+    NNUEWeights::setDefaultPath(appDir + "/connect6.nnue");
+    // Read while the menu is built and shown, so the engines of the board
+    // view find them loaded instead of parsing the files on the GUI thread.
+    std::thread weightLoader([]() {
+        PatternWeights::shared();
+        NNUEWeights::shared();
+    });
     
     MainWindow window;
+    if (argc > 1 && std::strcmp(argv[1], "--startup-benchmark") == 0) {
+        benchmarkStartup(app, window, launched);
+    }
     window.show();
+
+    QTimer metricsTimer;
+    if (const char* path = std::getenv("CONNECT6_METRICS")) {
+        std::string metricsPath = path;
+        QObject::connect(&metricsTimer, &QTimer::timeout, [metricsPath]() {
+            MetricsRegistry::global().dump(metricsPath);
+        });
+        metricsTimer.start(METRICS_DUMP_INTERVAL_MS);
+    }
     
-    return app.exec();
-} 
\ No newline at end of file
+    int status = app.exec();
+    weightLoader.join();
+    return exportMetrics(exportProfile(status));
+}
@@ -0,0 +1,332 @@
+#include "protocol/EngineProtocol.h"
+#include "core/MoveNotation.h"
+#include "core/Profiler.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+namespace {
+
+std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+std::string formatScore(int score) {
+    // Wins and losses are reported in plies, like UCI's "score mate".
+    int distance = GameAI::WIN_SCORE - std::abs(score);
+    if (distance >= 0 && distance <= GameBoard::BOARD_SIZE * GameBoard::BOARD_SIZE) {
+        return (score > 0 ? "win " : "loss ") + std::to_string(distance);
+    }
+    return "cp " + std::to_string(score);
+}
+
+} // namespace
+
+EngineProtocol::EngineProtocol(std::istream& in, std::ostream& out)
+    : in(in)
+    , out(out)
+    , multiPV(1)
+    , searching(false)
+    , pondering(false)
+    , budgetMs(0)
+    , timed(false) {
+    ai.setVerbose(false);
+}
+
+EngineProtocol::~EngineProtocol() {
+    stopSearch();
+}
+
+int EngineProtocol::run() {
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!handleCommand(line)) break;
+    }
+    stopSearch();
+    return 0;
+}
+
+bool EngineProtocol::handleCommand(const std::string& line) {
+    std::istringstream args(line);
+    std::string command;
+    if (!(args >> command)) return true;
+
+    if (command == "uci") {
+        send("id name Connect6");
+        send("option name Difficulty type combo default Medium var Easy var Medium var Hard");
+        send("option name Engine type combo default Minimax var Minimax var MCTS");
+        send("option name MultiPV type spin default 1 min 1 max " + std::to_string(MAX_MULTI_PV));
+        send("option name Hash type spin default "
+             + std::to_string(TranspositionTable::DEFAULT_ENTRIES * TranspositionTable::ENTRY_BYTES >> 20)
+             + " min 1 max " + std::to_string(MAX_HASH_MB));
+        send("uciok");
+    } else if (command == "isready") {
+        send("readyok");
+    } else if (command == "ucinewgame") {
+        stopSearch();
+        board.reset();
+        ai.newGame();
+    } else if (command == "setoption") {
+        std::string token, name, value;
+        std::string* target = nullptr;
+        while (args >> token) {
+            if (token == "name") target = &name;
+            else if (token == "value") target = &value;
+            else if (target) *target += (target->empty() ? "" : " ") + token;
+        }
+        stopSearch();
+        setOption(toLower(name), toLower(value));
+    } else if (command == "position") {
+        stopSearch();
+        setPosition(args);
+    } else if (command == "go") {
+        stopSearch();
+        startSearch(args);
+    } else if (command == "stop") {
+        stopSearch();
+    } else if (command == "ponderhit") {
+        ponderHit();
+    } else if (command == "quit") {
+        stopSearch();
+        return false;
+    } else {
+        send("info string unknown command " + command);
+    }
+    return true;
+}
+
+int EngineProtocol::moveBudgetMs(const SearchLimits& limits, Player player) {
+    if (limits.moveTimeMs > 0) return limits.moveTimeMs;
+
+    int remaining = player == Player::BLACK ? limits.blackTimeMs : limits.whiteTimeMs;
+    int increment = player == Player::BLACK ? limits.blackIncrementMs : limits.whiteIncrementMs;
+    if (remaining <= 0) return 0;
+
+    int movesLeft = limits.movesToGo > 0 ? limits.movesToGo : DEFAULT_MOVES_TO_GO;
+    int budget = remaining / movesLeft + increment * 3 / 4;
+    // Never plan to use the last few milliseconds of the clock.
+    return std::max(1, std::min(budget, remaining - MOVE_OVERHEAD_MS));
+}
+
+void EngineProtocol::send(const std::string& line) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    out << line << std::endl;
+}
+
+void EngineProtocol::setOption(const std::string& name, const std::string& value) {
+    if (name == "difficulty") {
+        if (value == "easy") ai.setDifficulty(AIDifficulty::EASY);
+        else if (value == "medium") ai.setDifficulty(AIDifficulty::MEDIUM);
+        else if (value == "hard") ai.setDifficulty(AIDifficulty::HARD);
+        else send("info string invalid difficulty " + value);
+    } else if (name == "engine") {
+        if (value == "minimax") ai.setEngine(AIEngine::MINIMAX);
+        else if (value == "mcts") ai.setEngine(AIEngine::MCTS);
+        else send("info string invalid engine " + value);
+    } else if (name == "multipv") {
+        int lines = std::atoi(value.c_str());
+        if (lines >= 1 && lines <= MAX_MULTI_PV) multiPV = lines;
+        else send("info string invalid multipv " + value);
+    } else if (name == "hash") {
+        int megabytes = std::atoi(value.c_str());
+        if (megabytes >= 1 && megabytes <= MAX_HASH_MB) ai.setTableMegabytes(megabytes);
+        else send("info string invalid hash " + value);
+    } else {
+        send("info string unknown option " + name);
+    }
+}
+
+void EngineProtocol::setPosition(std::istringstream& args) {
+    std::string token;
+    args >> token;
+    GameBoard position;
+    if (token == "file") {
+        std::string path;
+        args >> path;
+        if (!position.loadGame(path)) {
+            send("info string failed to load " + path);
+            return;
+        }
+        args >> token;
+    } else if (token == "startpos") {
+        args >> token;
+    } else {
+        send("info string expected startpos or file");
+        return;
+    }
+
+    if (token == "moves") {
+        std::string text;
+        while (args >> text) {
+            std::pair<int, int> move;
+            if (!parseMove(text, move) || position.getGameState() != GameState::IN_PROGRESS ||
+                !position.makeMove(move.first, move.second, position.getCurrentPlayer())) {
+                send("info string illegal move " + text);
+                return;
+            }
+        }
+    }
+    board = position;
+}
+
+void EngineProtocol::startSearch(std::istringstream& args) {
+    limits = SearchLimits();
+    std::string token;
+    while (args >> token) {
+        if (token == "ponder") limits.ponder = true;
+        else if (token == "infinite") limits.infinite = true;
+        else if (token == "btime") args >> limits.blackTimeMs;
+        else if (token == "wtime") args >> limits.whiteTimeMs;
+        else if (token == "binc") args >> limits.blackIncrementMs;
+        else if (token == "winc") args >> limits.whiteIncrementMs;
+        else if (token == "movestogo") args >> limits.movesToGo;
+        else if (token == "movetime") args >> limits.moveTimeMs;
+        else if (token == "depth") args >> limits.depth;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(searchMutex);
+        searching = true;
+        pondering = limits.ponder;
+        budgetMs = limits.infinite ? 0 : moveBudgetMs(limits, board.getCurrentPlayer());
+        searchStart = std::chrono::steady_clock::now();
+        // A ponder search has no deadline until ponderhit starts the clock.
+        timed = budgetMs > 0 && !pondering;
+        deadline = searchStart + std::chrono::milliseconds(budgetMs);
+    }
+    ai.clearStopRequest();
+    timer = std::thread(&EngineProtocol::runTimer, this);
+    position = board;
+    worker = std::thread(&EngineProtocol::search, this);
+}
+
+void EngineProtocol::stopSearch() {
+    {
+        std::lock_guard<std::mutex> lock(searchMutex);
+        if (searching) ai.requestStop();
+        pondering = false;
+        searchChanged.notify_all();
+    }
+    if (worker.joinable()) worker.join();
+    if (timer.joinable()) timer.join();
+    ai.clearStopRequest();
+}
+
+void EngineProtocol::ponderHit() {
+    std::lock_guard<std::mutex> lock(searchMutex);
+    if (!pondering) return;
+    pondering = false;
+    searchStart = std::chrono::steady_clock::now();
+    deadline = searchStart + std::chrono::milliseconds(budgetMs);
+    timed = budgetMs > 0;
+    searchChanged.notify_all();
+}
+
+void EngineProtocol::runTimer() {
+    std::unique_lock<std::mutex> lock(searchMutex);
+    while (searching) {
+        if (!timed) {
+            searchChanged.wait(lock);
+        } else if (searchChanged.wait_until(lock, deadline) == std::cv_status::timeout &&
+                   searching && timed && std::chrono::steady_clock::now() >= deadline) {
+            ai.requestStop();
+            return;
+        }
+    }
+}
+
+int EngineProtocol::defaultDepth() const {
+    switch (ai.getDifficulty()) {
+        case AIDifficulty::EASY: return 1;
+        case AIDifficulty::MEDIUM: return 3;
+        case AIDifficulty::HARD: return 7;
+    }
+    return 3;
+}
+
+void EngineProtocol::search() {
+    Profiler::setThreadName("search");
+    Player player = position.getCurrentPlayer();
+    std::pair<int, int> best = {-1, -1};
+    std::pair<int, int> ponderMove = {-1, -1};
+
+    if (position.getGameState() == GameState::IN_PROGRESS) {
+        if (ai.getEngine() == AIEngine::MCTS) {
+            // MCTS has no depth. A clock or movetime bounds its time in place
+            // of the difficulty's limits; infinite and ponder searches run
+            // until stopped.
+            if (limits.depth > 0) send("info string depth is not supported by MCTS");
+            bool untimed = limits.infinite || limits.ponder;
+            int budget = untimed ? 0 : moveBudgetMs(limits, player);
+            ai.setMCTSLimits(untimed || budget > 0 ? std::numeric_limits<uint64_t>::max() : 0,
+                             untimed ? std::numeric_limits<int>::max() : budget);
+            best = ai.getBestMove(position, player);
+            ai.setMCTSLimits(0, 0);
+        } else {
+            // Time-limited searches deepen until the clock runs out; the
+            // others stop at the requested or difficulty depth.
+            int maxDepth = limits.depth > 0 ? limits.depth
+                         : (limits.infinite || limits.ponder || moveBudgetMs(limits, player) > 0) ? MAX_SEARCH_DEPTH
+                         : defaultDepth();
+            std::pair<int, int> lastBest = {-1, -1};
+            int lastDepth = 0;
+            AnalysisInfo partial;
+            AnalysisInfo result = ai.analyze(position, player, maxDepth, multiPV, [&](const AnalysisInfo& info) {
+                partial = info;
+                reportProgress(info, lastBest, lastDepth);
+            });
+            const AnalysisInfo& used = result.bestMoves.empty() ? partial : result;
+            if (!used.bestMoves.empty()) best = used.bestMoves.front().move;
+            if (used.pv.size() > 1) ponderMove = used.pv[1];
+        }
+        if (best.first < 0) {
+            std::vector<std::pair<int, int>> moves = position.getValidMoves();
+            if (!moves.empty()) best = moves.front();
+        }
+    }
+
+    // A ponder search may not answer before ponderhit or stop.
+    std::unique_lock<std::mutex> lock(searchMutex);
+    searchChanged.wait(lock, [this]() { return !pondering; });
+    searching = false;
+    searchChanged.notify_all();
+    lock.unlock();
+
+    send("bestmove " + formatMove(best) + (ponderMove.first >= 0 ? " ponder " + formatMove(ponderMove) : ""));
+}
+
+void EngineProtocol::reportProgress(const AnalysisInfo& info, std::pair<int, int>& lastBest, int& lastDepth) {
+    if (info.bestMoves.empty()) return;
+    bool depthDone = info.searchedMoves == info.totalMoves;
+    if (!depthDone && info.bestMoves.front().move == lastBest && info.depth == lastDepth) return;
+    lastBest = info.bestMoves.front().move;
+    lastDepth = info.depth;
+
+    int64_t elapsedMs;
+    {
+        std::lock_guard<std::mutex> lock(searchMutex);
+        auto elapsed = std::chrono::steady_clock::now() - searchStart;
+        elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+        // The next depth takes several times longer than this one, so a depth
+        // finishing after half the budget would most likely be wasted.
+        if (depthDone && timed && elapsedMs * 2 >= budgetMs) ai.requestStop();
+    }
+
+    // A finished depth reports every line; in between only the new best.
+    size_t lines = depthDone ? info.bestMoves.size() : 1;
+    for (size_t i = 0; i < lines; ++i) {
+        std::ostringstream line;
+        line << "info depth " << info.depth;
+        if (multiPV > 1) line << " multipv " << i + 1;
+        line << " score " << formatScore(info.bestMoves[i].score)
+             << " time " << elapsedMs
+             << " currmovenumber " << info.searchedMoves << " pv";
+        for (const auto& move : info.pvs[i]) line << ' ' << formatMove(move);
+        send(line.str());
+    }
+}
@@ -0,0 +1,348 @@
+#include "service/GameService.h"
+#include <algorithm>
+#include <sstream>
+#include "core/MoveNotation.h"
+#include "core/Profiler.h"
+
+namespace {
+
+const char* const DIFFICULTY_NAMES[] = {"easy", "medium", "hard"};
+const int DIFFICULTY_DEPTHS[] = {1, 3, 7};
+
+} // namespace
+
+GameService::GameService(const ServiceConfig& config, std::shared_ptr<const OpeningBook> book)
+    : config(config)
+    , book(book ? book : std::make_shared<OpeningBook>())
+    , stopping(false)
+    , requests(0)
+    , searches(0)
+    , bookMoves(0)
+    , rejected(0)
+    , sessionsOpened(0)
+    , sessionsClosed(0) {
+    int count = config.workers > 0 ? config.workers : static_cast<int>(std::thread::hardware_concurrency());
+    count = std::max(1, count);
+    for (int i = 0; i < count; ++i) {
+        workers.emplace_back(new Worker());
+        workers.back()->ai.setVerbose(false);
+    }
+    for (auto& worker : workers) {
+        worker->thread = std::thread(&GameService::runWorker, this, std::ref(*worker));
+    }
+    watchdog = std::thread(&GameService::runWatchdog, this);
+}
+
+GameService::~GameService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        for (auto& worker : workers) worker->ai.requestStop();
+    }
+    timerChanged.notify_all();
+    for (auto& worker : workers) worker->thread.join();
+    watchdog.join();
+    // Every reply is owed, including those of requests no worker reached.
+    for (auto& queue : pending) {
+        for (Request& request : queue.second) request.reply(std::to_string(request.id) + " error shutting down");
+    }
+}
+
+void GameService::handle(const std::string& line, const ServiceReply& reply) {
+    requests++;
+    std::istringstream args(line);
+    std::string command;
+    args >> command;
+
+    if (command == "new") {
+        std::string name = "medium";
+        args >> name;
+        const char* const* found = std::find(DIFFICULTY_NAMES, DIFFICULTY_NAMES + 3, name);
+        if (found == DIFFICULTY_NAMES + 3) {
+            rejected++;
+            reply("error unknown difficulty " + name);
+            return;
+        }
+        uint32_t id = openSession(static_cast<int>(found - DIFFICULTY_NAMES));
+        if (id == 0) {
+            rejected++;
+            reply("error too many sessions");
+            return;
+        }
+        reply("new " + std::to_string(id));
+        return;
+    }
+    if (command == "stats") {
+        ServiceStats stats = getStats();
+        std::ostringstream out;
+        out << "stats sessions " << stats.openSessions << " opened " << stats.sessionsOpened
+            << " closed " << stats.sessionsClosed << " requests " << stats.requests
+            << " searches " << stats.searches << " book " << stats.bookMoves
+            << " rejected " << stats.rejected << " queued " << stats.queuedSessions;
+        reply(out.str());
+        return;
+    }
+
+    Request request;
+    request.argument = 0;
+    request.reply = reply;
+    if (command == "move") request.command = Command::MOVE;
+    else if (command == "go") request.command = Command::GO;
+    else if (command == "show") request.command = Command::SHOW;
+    else if (command == "close") request.command = Command::CLOSE;
+    else {
+        rejected++;
+        reply("error unknown command " + command);
+        return;
+    }
+
+    uint32_t slot;
+    if (!(args >> request.id) || !lookup(request.id, slot)) {
+        rejected++;
+        reply("error unknown session");
+        return;
+    }
+    std::string prefix = std::to_string(request.id) + " ";
+
+    if (request.command == Command::MOVE) {
+        std::string text;
+        std::pair<int, int> move;
+        if (!(args >> text) || !parseMove(text, move)) {
+            rejected++;
+            reply(prefix + "error bad move");
+            return;
+        }
+        request.argument = move.first * GameBoard::BOARD_SIZE + move.second;
+    } else if (request.command == Command::GO) {
+        std::string token;
+        int budget = config.defaultBudgetMs;
+        if (args >> token && token == "movetime" && !(args >> budget)) {
+            rejected++;
+            reply(prefix + "error bad movetime");
+            return;
+        }
+        request.argument = std::max(1, std::min(budget, config.maxBudgetMs));
+    }
+    enqueue(slot, std::move(request));
+}
+
+ServiceStats GameService::getStats() const {
+    ServiceStats stats;
+    stats.requests = requests.load();
+    stats.searches = searches.load();
+    stats.bookMoves = bookMoves.load();
+    stats.rejected = rejected.load();
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.sessionsOpened = sessionsOpened;
+    stats.sessionsClosed = sessionsClosed;
+    stats.openSessions = static_cast<size_t>(sessionsOpened - sessionsClosed);
+    stats.queuedSessions = readySlots.size();
+    return stats;
+}
+
+// Ids are the slot index plus a generation in the high bits, so the id of a
+// closed session is not valid for the next session reusing its slot.
+uint32_t GameService::openSession(int difficulty) {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        if (sessions.size() >= std::min<size_t>(config.maxSessions, (1u << SLOT_BITS) - 1)) return 0;
+        sessions.emplace_back();
+        slot = static_cast<uint32_t>(sessions.size());
+    }
+    Session& session = sessions[slot - 1];
+    session.open = true;
+    session.difficulty = static_cast<uint8_t>(difficulty);
+    session.moveCount = 0;
+    sessionsOpened++;
+    return (static_cast<uint32_t>(session.generation) << SLOT_BITS) | slot;
+}
+
+bool GameService::lookup(uint32_t id, uint32_t& slot) const {
+    slot = id & ((1u << SLOT_BITS) - 1);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (slot == 0 || slot > sessions.size()) return false;
+    const Session& session = sessions[slot - 1];
+    return session.open && (id >> SLOT_BITS) == session.generation;
+}
+
+void GameService::enqueue(uint32_t slot, Request request) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending[slot].push_back(std::move(request));
+        Session& session = sessions[slot - 1];
+        if (session.queued) return;
+        session.queued = true;
+        readySlots.push_back(slot);
+    }
+    ready.notify_one();
+}
+
+void GameService::runWorker(Worker& worker) {
+    Profiler::setThreadName("service worker");
+    while (true) {
+        uint32_t slot;
+        Request request;
+        Session session;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [this]() { return stopping || !readySlots.empty(); });
+            if (stopping) return;
+            slot = readySlots.front();
+            readySlots.pop_front();
+            std::deque<Request>& queue = pending[slot];
+            request = std::move(queue.front());
+            queue.pop_front();
+            // Workers run a copy: the vector may grow while the search runs.
+            session = sessions[slot - 1];
+        }
+
+        std::string reply;
+        if (!session.open || (request.id >> SLOT_BITS) != session.generation) {
+            rejected++;
+            reply = "error unknown session";
+        } else {
+            reply = process(worker, session, request);
+        }
+
+        bool more;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Session& stored = sessions[slot - 1];
+            if (stored.open && stored.generation == session.generation) {
+                stored.moveCount = session.moveCount;
+                std::copy(session.moves, session.moves + session.moveCount, stored.moves);
+                if (!session.open) {
+                    stored.open = false;
+                    stored.generation = static_cast<uint16_t>((stored.generation + 1) & 0xfff);
+                    freeSlots.push_back(slot);
+                    sessionsClosed++;
+                }
+            }
+            // Back of the line: every other waiting session gets a turn first.
+            std::deque<Request>& queue = pending[slot];
+            more = !queue.empty();
+            if (more) {
+                readySlots.push_back(slot);
+            } else {
+                pending.erase(slot);
+                stored.queued = false;
+            }
+        }
+        if (more) ready.notify_one();
+        request.reply(reply);
+    }
+}
+
+std::string GameService::process(Worker& worker, Session& session, const Request& request) {
+    std::string prefix = std::to_string(request.id) + " ";
+    if (request.command == Command::CLOSE) {
+        session.open = false;
+        return prefix + "closed";
+    }
+
+    GameBoard& board = worker.board;
+    board.reset();
+    for (int i = 0; i < session.moveCount; ++i) {
+        board.makeMove(session.moves[i] / GameBoard::BOARD_SIZE, session.moves[i] % GameBoard::BOARD_SIZE,
+                       board.getCurrentPlayer());
+    }
+
+    if (request.command == Command::SHOW) {
+        std::string reply = prefix + "moves";
+        for (int i = 0; i < session.moveCount; ++i) {
+            reply += " " + formatMove({session.moves[i] / GameBoard::BOARD_SIZE, session.moves[i] % GameBoard::BOARD_SIZE});
+        }
+        return reply + " state " + stateName(board.getGameState());
+    }
+
+    std::pair<int, int> move;
+    if (request.command == Command::MOVE) {
+        move = {request.argument / GameBoard::BOARD_SIZE, request.argument % GameBoard::BOARD_SIZE};
+        if (board.getGameState() != GameState::IN_PROGRESS || !board.isValidMove(move.first, move.second)) {
+            rejected++;
+            return prefix + "error illegal move";
+        }
+    } else {
+        if (board.getGameState() != GameState::IN_PROGRESS) {
+            return prefix + "bestmove none state " + stateName(board.getGameState());
+        }
+        if (book->probe(board, move)) {
+            bookMoves++;
+        } else {
+            move = search(worker, session.difficulty, request.argument);
+            searches++;
+        }
+    }
+
+    board.makeMove(move.first, move.second, board.getCurrentPlayer());
+    session.moves[session.moveCount++] = static_cast<uint8_t>(move.first * GameBoard::BOARD_SIZE + move.second);
+    if (request.command == Command::MOVE) return prefix + "ok state " + stateName(board.getGameState());
+    return prefix + "bestmove " + formatMove(move) + " state " + stateName(board.getGameState());
+}
+
+// Iterative deepening up to the session's difficulty depth; the watchdog
+// stops it at the budget and the last finished depth answers. A worker's
+// engine serves sessions of every difficulty, but each analyze() starts
+// from an empty table, so no session cuts off on another's results.
+std::pair<int, int> GameService::search(Worker& worker, int difficulty, int budgetMs) {
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        worker.ai.clearStopRequest();
+        worker.timed = true;
+        worker.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(budgetMs);
+    }
+    timerChanged.notify_one();
+
+    AnalysisInfo partial;
+    AnalysisInfo result = worker.ai.analyze(worker.board, worker.board.getCurrentPlayer(), DIFFICULTY_DEPTHS[difficulty], 1,
+                                            [&](const AnalysisInfo& info) { partial = info; });
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        worker.timed = false;
+    }
+
+    const AnalysisInfo& used = result.bestMoves.empty() ? partial : result;
+    if (!used.bestMoves.empty()) return used.bestMoves.front().move;
+    return worker.board.getValidMoves().front();
+}
+
+void GameService::runWatchdog() {
+    std::unique_lock<std::mutex> lock(timerMutex);
+    while (true) {
+        {
+            std::lock_guard<std::mutex> state(mutex);
+            if (stopping) return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        auto next = std::chrono::steady_clock::time_point::max();
+        for (auto& worker : workers) {
+            if (!worker->timed) continue;
+            if (worker->deadline <= now) {
+                worker->ai.requestStop();
+                worker->timed = false;
+            } else {
+                next = std::min(next, worker->deadline);
+            }
+        }
+        if (next == std::chrono::steady_clock::time_point::max()) timerChanged.wait(lock);
+        else timerChanged.wait_until(lock, next);
+    }
+}
+
+std::string GameService::stateName(GameState state) {
+    switch (state) {
+        case GameState::IN_PROGRESS: return "in_progress";
+        case GameState::BLACK_WIN: return "black_win";
+        case GameState::WHITE_WIN: return "white_win";
+        case GameState::DRAW: return "draw";
+    }
+    return "unknown";
+}
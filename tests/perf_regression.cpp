@@ -0,0 +1,246 @@
+// Search regression test: plays every corpus position at one difficulty and
+// compares the chosen move, the node count and the search time against the
+// checked-in baseline.
+//
+// perf_regression <corpus> <baseline> <difficulty> [--update]
+//
+// Corpus lines are "name | moves | expectations", where expectations look like
+// "easy=g5 medium,hard=b5,g5" or "*=h10". A difficulty without an expectation
+// is only checked for nodes and time. Baseline lines are
+// "name difficulty nodes microseconds"; --update rewrites the entries for the
+// given difficulty from this run instead of checking them.
+//
+// Searches run in deterministic mode, so node counts are exact and any
+// increase beyond CONNECT6_PERF_NODE_TOLERANCE (default 0.05) fails. Time is
+// noisier: a position fails when it takes longer than
+// CONNECT6_PERF_TIME_FACTOR (default 2.0) times its baseline plus 20 ms.
+// A factor of 0 disables the time check, e.g. on shared CI machines.
+#include "ai/GameAI.h"
+#include "ai/NNUEEvaluator.h"
+#include "ai/PatternEvaluator.h"
+#include "core/MoveNotation.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* const BASELINE_HEADER = "connect6-perf 1";
+const int64_t TIME_SLACK_US = 20000;
+
+struct Position {
+    std::string name;
+    std::unique_ptr<GameBoard> board;
+    std::map<std::string, std::vector<std::pair<int, int>>> expected;
+};
+
+struct Sample {
+    uint64_t nodes = 0;
+    int64_t elapsedUs = 0;
+};
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return std::string();
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+std::vector<std::string> split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::istringstream in(text);
+    std::string part;
+    while (std::getline(in, part, separator)) parts.push_back(trim(part));
+    return parts;
+}
+
+bool parseDifficulty(const std::string& name, AIDifficulty& difficulty) {
+    if (name == "easy") difficulty = AIDifficulty::EASY;
+    else if (name == "medium") difficulty = AIDifficulty::MEDIUM;
+    else if (name == "hard") difficulty = AIDifficulty::HARD;
+    else return false;
+    return true;
+}
+
+bool parsePosition(const std::string& line, Position& position) {
+    std::vector<std::string> fields = split(line, '|');
+    if (!line.empty() && line.back() == '|') fields.push_back(std::string());
+    if (fields.size() != 3 || fields[0].empty()) return false;
+    position.name = fields[0];
+
+    position.board.reset(new GameBoard());
+    std::istringstream moves(fields[1]);
+    std::string word;
+    while (moves >> word) {
+        std::pair<int, int> move;
+        GameBoard& board = *position.board;
+        if (!parseMove(word, move) || !board.makeMove(move.first, move.second, board.getCurrentPlayer())) return false;
+    }
+    if (position.board->getGameState() != GameState::IN_PROGRESS) return false;
+
+    std::istringstream expectations(fields[2]);
+    while (expectations >> word) {
+        size_t equals = word.find('=');
+        if (equals == std::string::npos) return false;
+        std::vector<std::pair<int, int>> cells;
+        for (const std::string& cell : split(word.substr(equals + 1), ',')) {
+            std::pair<int, int> move;
+            if (!parseMove(cell, move)) return false;
+            cells.push_back(move);
+        }
+        for (const std::string& level : split(word.substr(0, equals), ',')) {
+            AIDifficulty unused;
+            if (level != "*" && !parseDifficulty(level, unused)) return false;
+            position.expected[level] = cells;
+        }
+    }
+    return true;
+}
+
+bool loadCorpus(const std::string& path, std::vector<Position>& corpus) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "cannot open corpus " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        Position position;
+        if (!parsePosition(line, position)) {
+            std::cerr << path << ":" << lineNumber << ": bad corpus line" << std::endl;
+            return false;
+        }
+        corpus.push_back(std::move(position));
+    }
+    return true;
+}
+
+// Keyed by "name difficulty". A missing file is an empty baseline.
+bool loadBaseline(const std::string& path, std::map<std::string, Sample>& baseline) {
+    std::ifstream in(path);
+    if (!in) return true;
+    std::string line;
+    if (!std::getline(in, line) || trim(line) != BASELINE_HEADER) {
+        std::cerr << "bad baseline header in " << path << std::endl;
+        return false;
+    }
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string name, level;
+        Sample sample;
+        if (!(fields >> name >> level >> sample.nodes >> sample.elapsedUs)) continue;
+        baseline[name + " " + level] = sample;
+    }
+    return true;
+}
+
+bool saveBaseline(const std::string& path, const std::map<std::string, Sample>& baseline) {
+    std::ofstream out(path);
+    out << BASELINE_HEADER << "\n";
+    for (const auto& entry : baseline) {
+        out << entry.first << " " << entry.second.nodes << " " << entry.second.elapsedUs << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+double envDouble(const char* name, double fallback) {
+    const char* value = std::getenv(name);
+    return value ? std::atof(value) : fallback;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 4 || (argc == 5 && std::string(argv[4]) != "--update") || argc > 5) {
+        std::cerr << "usage: perf_regression <corpus> <baseline> <easy|medium|hard> [--update]" << std::endl;
+        return 2;
+    }
+    const std::string corpusPath = argv[1];
+    const std::string baselinePath = argv[2];
+    const std::string level = argv[3];
+    const bool update = argc == 5;
+
+    AIDifficulty difficulty;
+    if (!parseDifficulty(level, difficulty)) {
+        std::cerr << "unknown difficulty " << level << std::endl;
+        return 2;
+    }
+
+    // Tuned weight files in the working directory must not move the baseline.
+    PatternWeights::setDefaultPath(std::string());
+    NNUEWeights::setDefaultPath(std::string());
+
+    std::vector<Position> corpus;
+    std::map<std::string, Sample> baseline;
+    if (!loadCorpus(corpusPath, corpus) || !loadBaseline(baselinePath, baseline)) return 2;
+
+    const double nodeTolerance = envDouble("CONNECT6_PERF_NODE_TOLERANCE", 0.05);
+    const double timeFactor = envDouble("CONNECT6_PERF_TIME_FACTOR", 2.0);
+
+    int failures = 0;
+    for (const Position& position : corpus) {
+        GameAI ai;
+        ai.setVerbose(false);
+        ai.setSeed(1);
+        ai.setDifficulty(difficulty);
+
+        ScoredMove result = ai.getScoredMove(*position.board, position.board->getCurrentPlayer());
+        Sample sample;
+        sample.nodes = ai.getLastSearchStats().nodes + ai.getLastSearchStats().solverNodes;
+        sample.elapsedUs = ai.getLastSearchStats().elapsedUs;
+
+        std::vector<std::string> problems;
+        auto expected = position.expected.find(level);
+        if (expected == position.expected.end()) expected = position.expected.find("*");
+        if (expected != position.expected.end()
+            && std::find(expected->second.begin(), expected->second.end(), result.move) == expected->second.end()) {
+            problems.push_back("unexpected move");
+        }
+
+        const std::string key = position.name + " " + level;
+        auto reference = baseline.find(key);
+        std::ostringstream compare;
+        if (update) {
+            baseline[key] = sample;
+        } else if (reference == baseline.end()) {
+            problems.push_back("no baseline");
+        } else {
+            const Sample& base = reference->second;
+            compare << std::fixed << std::setprecision(1) << "  (baseline " << base.nodes << ", " << base.elapsedUs / 1000.0 << " ms)";
+            if (sample.nodes > base.nodes * (1.0 + nodeTolerance)) problems.push_back("node regression");
+            if (timeFactor > 0 && sample.elapsedUs > base.elapsedUs * timeFactor + TIME_SLACK_US) {
+                problems.push_back("time regression");
+            }
+        }
+
+        std::cout << std::left << std::setw(20) << position.name << std::right
+                  << std::setw(5) << formatMove(result.move)
+                  << std::setw(12) << sample.nodes << " nodes"
+                  << std::setw(10) << std::fixed << std::setprecision(1) << sample.elapsedUs / 1000.0 << " ms"
+                  << compare.str();
+        for (const std::string& problem : problems) std::cout << "  FAIL: " << problem;
+        std::cout << std::endl;
+        if (!problems.empty()) ++failures;
+    }
+
+    if (update) {
+        if (!saveBaseline(baselinePath, baseline)) {
+            std::cerr << "failed to write " << baselinePath << std::endl;
+            return 2;
+        }
+        std::cout << "updated " << baselinePath << std::endl;
+    }
+    std::cout << failures << " of " << corpus.size() << " positions failed" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+// Records or verifies minimax search traces, to compare two engine builds
+// node for node.
+//
+// search_trace record <trace> [options] [game files...]
+// search_trace verify <trace> [options] [game files...]
+//
+//   --moves "h8 i9 ..."    add a start position given as moves (repeatable)
+//   --difficulty <level>   easy, medium (default) or hard
+//   --plies N              moves the engine plays from each position (default 1)
+//   --seed N               deterministic seed (default 1)
+//
+// With no positions the empty board is used. "record" writes every search to
+// <trace>; "verify" replays the same searches against it and prints the
+// first node that differs, with the moves leading to it.
+#include "ai/GameAI.h"
+#include "ai/SearchTrace.h"
+#include "core/MoveNotation.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    bool verify = false;
+    std::string trace;
+    std::vector<std::unique_ptr<GameBoard>> positions;
+    AIDifficulty difficulty = AIDifficulty::MEDIUM;
+    int plies = 1;
+    uint64_t seed = 1;
+};
+
+bool addMoves(const std::string& text, Options& options) {
+    std::unique_ptr<GameBoard> board(new GameBoard());
+    std::istringstream words(text);
+    std::string word;
+    while (words >> word) {
+        std::pair<int, int> move;
+        if (!parseMove(word, move) || !board->makeMove(move.first, move.second, board->getCurrentPlayer())) return false;
+    }
+    options.positions.push_back(std::move(board));
+    return true;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    if (argc < 3) return false;
+    if (std::strcmp(argv[1], "verify") == 0) options.verify = true;
+    else if (std::strcmp(argv[1], "record") != 0) return false;
+    options.trace = argv[2];
+
+    for (int i = 3; i < argc; ++i) {
+        std::string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (option == "--moves" && hasValue) {
+            if (!addMoves(argv[++i], options)) {
+                std::cerr << "bad moves: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (option == "--difficulty" && hasValue) {
+            std::string level = argv[++i];
+            if (level == "easy") options.difficulty = AIDifficulty::EASY;
+            else if (level == "medium") options.difficulty = AIDifficulty::MEDIUM;
+            else if (level == "hard") options.difficulty = AIDifficulty::HARD;
+            else return false;
+        } else if (option == "--plies" && hasValue) {
+            options.plies = std::max(1, std::atoi(argv[++i]));
+        } else if (option == "--seed" && hasValue) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (option.compare(0, 2, "--") == 0) {
+            return false;
+        } else {
+            std::unique_ptr<GameBoard> board(new GameBoard());
+            if (!board->loadGame(option)) {
+                std::cerr << "failed to load " << option << std::endl;
+                return false;
+            }
+            options.positions.push_back(std::move(board));
+        }
+    }
+    if (options.positions.empty()) options.positions.emplace_back(new GameBoard());
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " record|verify <trace> [--moves \"h8 i9\"] [--difficulty level]"
+                  << " [--plies N] [--seed N] [game files...]" << std::endl;
+        return 2;
+    }
+
+    SearchTrace trace;
+    if (options.verify && !trace.load(options.trace)) {
+        std::cerr << "failed to load " << options.trace << std::endl;
+        return 1;
+    }
+
+    GameAI ai;
+    ai.setVerbose(false);
+    ai.setSeed(options.seed);
+    ai.setDifficulty(options.difficulty);
+    ai.setTrace(&trace);
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto& board : options.positions) {
+        for (int ply = 0; ply < options.plies && board->getGameState() == GameState::IN_PROGRESS; ++ply) {
+            std::pair<int, int> move = ai.getBestMove(*board, board->getCurrentPlayer());
+            board->makeMove(move.first, move.second, board->getCurrentPlayer());
+            if (trace.hasDivergence()) break;
+        }
+        if (trace.hasDivergence()) break;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!options.verify) {
+        if (!trace.save(options.trace)) {
+            std::cerr << "failed to write " << options.trace << std::endl;
+            return 1;
+        }
+        std::cout << "recorded " << trace.getNodes() << " nodes in " << trace.getBytes() << " bytes ("
+                  << seconds << " s)" << std::endl;
+        return 0;
+    }
+
+    if (trace.hasDivergence()) {
+        const TraceDivergence& divergence = trace.getDivergence();
+        std::cout << "diverged at node " << divergence.node << ", path";
+        for (const auto& move : divergence.path) std::cout << ' ' << formatMove(move);
+        std::cout << "\n  expected: " << divergence.expected << "\n  actual:   " << divergence.actual << std::endl;
+        return 3;
+    }
+    if (!trace.isComplete()) {
+        std::cout << "searches ended before the trace did, after " << trace.getNodes() << " nodes" << std::endl;
+        return 3;
+    }
+    std::cout << "identical: " << trace.getNodes() << " nodes (" << seconds << " s)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,342 @@
+// Texel-style tuner for PatternEvaluator.
+//
+// Plays self-play games with the minimax AI, records the positions after the
+// opening together with the final result, then adjusts the pattern, center
+// and defense weights so that sigmoid(evaluate / K) predicts the result as
+// well as possible. Each position is reduced to its PatternFeatures once, so
+// the error for new weights is recomputed without touching a board. With
+// --match the tuned weights then play the starting ones.
+//
+// tune_eval [--games N] [--threads N] [--in weights] [--out weights] [--match N]
+#include "ai/GameAI.h"
+#include "ai/PatternEvaluator.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int OPENING_MOVES = 6;        // random moves that start every game
+const int SKIP_PLIES = 10;          // positions this early say little about the result
+const double VALIDATION_SHARE = 0.1;
+
+const int PARAMETERS = PatternWeights::PATTERN_COUNT + 2;     // patterns, center, defense
+using Parameters = std::array<double, PARAMETERS>;
+
+struct Sample {
+    PatternFeatures features;
+    int ply;
+    double result;                  // 1 win, 0.5 draw, 0 loss for the side to move
+};
+
+struct Options {
+    int games = 400;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string in;
+    std::string out = "connect6.weights";
+    int matchGames = 0;
+};
+
+// Plays one game from a random opening and appends its positions to `samples`.
+void playGame(GameAI& ai, const PatternEvaluator& evaluator, std::mt19937& rng, std::vector<Sample>& samples) {
+    GameBoard board;
+    std::uniform_int_distribution<int> near(4, GameBoard::BOARD_SIZE - 5);
+    while (board.getMoveCount() < OPENING_MOVES) {
+        board.makeMove(near(rng), near(rng), board.getCurrentPlayer());
+    }
+
+    std::vector<std::pair<Sample, Player>> positions;
+    while (board.getGameState() == GameState::IN_PROGRESS) {
+        Player toMove = board.getCurrentPlayer();
+        if (board.getMoveCount() >= SKIP_PLIES) {
+            Sample sample;
+            evaluator.getFeatures(board, toMove, sample.features);
+            sample.ply = board.getMoveCount();
+            positions.emplace_back(sample, toMove);
+        }
+        std::pair<int, int> move = ai.getBestMove(board, toMove);
+        if (!board.makeMove(move.first, move.second, toMove)) break;
+    }
+
+    GameState state = board.getGameState();
+    Player winner = state == GameState::BLACK_WIN ? Player::BLACK :
+                    state == GameState::WHITE_WIN ? Player::WHITE : Player::NONE;
+    for (auto& position : positions) {
+        position.first.result = winner == Player::NONE ? 0.5 : (winner == position.second ? 1.0 : 0.0);
+        samples.push_back(position.first);
+    }
+}
+
+std::vector<Sample> selfPlay(const Options& options, const PatternWeights& weights) {
+    std::vector<Sample> samples;
+    std::mutex samplesMutex;
+    std::vector<std::thread> workers;
+    int gamesPerThread = (options.games + options.threads - 1) / options.threads;
+
+    for (int t = 0; t < options.threads; ++t) {
+        workers.emplace_back([&, t]() {
+            GameAI ai;
+            ai.setVerbose(false);
+            ai.setDifficulty(AIDifficulty::EASY);
+            ai.setEvaluator(std::make_unique<PatternEvaluator>(weights));
+            PatternEvaluator evaluator(weights);
+            std::mt19937 rng(1234 + t);
+
+            std::vector<Sample> local;
+            int first = t * gamesPerThread;
+            for (int game = first; game < std::min(options.games, first + gamesPerThread); ++game) {
+                playGame(ai, evaluator, rng, local);
+            }
+            std::lock_guard<std::mutex> lock(samplesMutex);
+            samples.insert(samples.end(), local.begin(), local.end());
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    return samples;
+}
+
+Parameters toParameters(const PatternWeights& weights) {
+    Parameters parameters;
+    for (int i = 0; i < PatternWeights::PATTERN_COUNT; ++i) parameters[i] = weights.patterns[i];
+    parameters[PatternWeights::PATTERN_COUNT] = weights.center;
+    parameters[PatternWeights::PATTERN_COUNT + 1] = weights.defense;
+    return parameters;
+}
+
+PatternWeights toWeights(const Parameters& parameters) {
+    PatternWeights weights;
+    for (int i = 0; i < PatternWeights::PATTERN_COUNT; ++i) weights.patterns[i] = static_cast<int>(std::lround(parameters[i]));
+    weights.center = static_cast<int>(std::lround(parameters[PatternWeights::PATTERN_COUNT]));
+    weights.defense = static_cast<int>(std::lround(parameters[PatternWeights::PATTERN_COUNT + 1]));
+    return weights;
+}
+
+double score(const PatternFeatures& features, const Parameters& parameters) {
+    double defense = parameters[PatternWeights::PATTERN_COUNT + 1] / 100.0;
+    double total = parameters[PatternWeights::PATTERN_COUNT] * features.center;
+    for (int i = 0; i < PatternWeights::PATTERN_COUNT; ++i) {
+        total += parameters[i] * (features.own[i] - defense * features.opponent[i]);
+    }
+    return total;
+}
+
+bool isOrdered(const Parameters& parameters) {
+    for (int i = PatternWeights::FIVE + 1; i < PatternWeights::PATTERN_COUNT; ++i) {
+        if (parameters[i] > parameters[i - 1]) return false;
+    }
+    return parameters[PatternWeights::FIVE] <= parameters[PatternWeights::SIX];
+}
+
+// Runs body(thread, first, last) over [begin, end) split across threads.
+template <typename Body>
+void parallelFor(size_t begin, size_t end, int threads, Body body) {
+    std::vector<std::thread> workers;
+    size_t chunk = (end - begin + threads - 1) / threads;
+    for (int t = 0; t < threads; ++t) {
+        size_t first = std::min(end, begin + t * chunk);
+        size_t last = std::min(end, first + chunk);
+        workers.emplace_back(body, t, first, last);
+    }
+    for (auto& worker : workers) worker.join();
+}
+
+// Mean squared error of sigmoid(score / scale) against the results. The
+// search only ever compares positions with the same number of stones, so
+// scores are measured against the mean score at their ply; an offset that
+// depends on the ply alone changes no move choice and is not fitted.
+double meanError(const std::vector<Sample>& samples, size_t begin, size_t end,
+                 const Parameters& parameters, double scale, int threads) {
+    const int plies = GameBoard::BOARD_SIZE * GameBoard::BOARD_SIZE + 1;
+    std::vector<std::vector<double>> sums(threads, std::vector<double>(plies, 0.0));
+    std::vector<std::vector<int>> counts(threads, std::vector<int>(plies, 0));
+    std::vector<double> scores(end - begin);
+    parallelFor(begin, end, threads, [&](int t, size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            scores[i - begin] = score(samples[i].features, parameters);
+            sums[t][samples[i].ply] += scores[i - begin];
+            counts[t][samples[i].ply]++;
+        }
+    });
+
+    std::vector<double> offsets(plies, 0.0);
+    for (int ply = 0; ply < plies; ++ply) {
+        double sum = 0.0;
+        int count = 0;
+        for (int t = 0; t < threads; ++t) {
+            sum += sums[t][ply];
+            count += counts[t][ply];
+        }
+        if (count > 0) offsets[ply] = sum / count;
+    }
+
+    std::vector<double> partial(threads, 0.0);
+    parallelFor(begin, end, threads, [&](int t, size_t first, size_t last) {
+        double sum = 0.0;
+        for (size_t i = first; i < last; ++i) {
+            double centered = scores[i - begin] - offsets[samples[i].ply];
+            double predicted = 1.0 / (1.0 + std::exp(-centered / scale));
+            double error = samples[i].result - predicted;
+            sum += error * error;
+        }
+        partial[t] = sum;
+    });
+
+    double total = 0.0;
+    for (double sum : partial) total += sum;
+    return end > begin ? total / (end - begin) : 0.0;
+}
+
+// Games between two weight sets from random openings, colors alternating.
+// Returns the points scored by `first` (1 per win, 0.5 per draw).
+double playMatch(const Options& options, const PatternWeights& first, const PatternWeights& second) {
+    std::vector<double> points(options.threads, 0.0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < options.threads; ++t) {
+        workers.emplace_back([&, t]() {
+            GameAI players[2];
+            const PatternWeights* weights[2] = {&first, &second};
+            for (int i = 0; i < 2; ++i) {
+                players[i].setVerbose(false);
+                players[i].setDifficulty(AIDifficulty::EASY);
+                players[i].setEvaluator(std::make_unique<PatternEvaluator>(*weights[i]));
+            }
+            std::mt19937 rng(5678 + t);
+            std::uniform_int_distribution<int> near(4, GameBoard::BOARD_SIZE - 5);
+
+            for (int game = t; game < options.matchGames; game += options.threads) {
+                GameBoard board;
+                while (board.getMoveCount() < OPENING_MOVES) {
+                    board.makeMove(near(rng), near(rng), board.getCurrentPlayer());
+                }
+                // `first` plays black in even games
+                Player firstColor = (game % 2 == 0) ? Player::BLACK : Player::WHITE;
+                while (board.getGameState() == GameState::IN_PROGRESS) {
+                    Player toMove = board.getCurrentPlayer();
+                    GameAI& ai = players[toMove == firstColor ? 0 : 1];
+                    std::pair<int, int> move = ai.getBestMove(board, toMove);
+                    if (!board.makeMove(move.first, move.second, toMove)) break;
+                }
+
+                GameState state = board.getGameState();
+                Player winner = state == GameState::BLACK_WIN ? Player::BLACK :
+                                state == GameState::WHITE_WIN ? Player::WHITE : Player::NONE;
+                if (winner == firstColor) points[t] += 1.0;
+                else if (state == GameState::DRAW) points[t] += 0.5;
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    double total = 0.0;
+    for (double value : points) total += value;
+    return total;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--games") == 0 && hasValue) options.games = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) options.threads = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--in") == 0 && hasValue) options.in = argv[++i];
+        else if (std::strcmp(argv[i], "--out") == 0 && hasValue) options.out = argv[++i];
+        else if (std::strcmp(argv[i], "--match") == 0 && hasValue) options.matchGames = std::atoi(argv[++i]);
+        else return false;
+    }
+    return options.games > 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--games N] [--threads N] [--in weights] [--out weights] [--match N]" << std::endl;
+        return 2;
+    }
+
+    PatternWeights initial;
+    if (!options.in.empty()) {
+        std::shared_ptr<const PatternWeights> loaded = PatternWeights::load(options.in);
+        if (!loaded) {
+            std::cerr << "failed to load " << options.in << std::endl;
+            return 1;
+        }
+        initial = *loaded;
+    }
+
+    std::cerr << "playing " << options.games << " games on " << options.threads << " threads..." << std::endl;
+    std::vector<Sample> samples = selfPlay(options, initial);
+    if (samples.size() < 100) {
+        std::cerr << "only " << samples.size() << " positions; play more games" << std::endl;
+        return 1;
+    }
+    std::shuffle(samples.begin(), samples.end(), std::mt19937(99));
+    size_t trainEnd = samples.size() - static_cast<size_t>(samples.size() * VALIDATION_SHARE);
+    std::cerr << samples.size() << " positions (" << trainEnd << " training)" << std::endl;
+
+    // Fit the sigmoid scale to the starting weights first, then keep it fixed
+    // so the weights cannot shrink the error just by changing units.
+    Parameters weights = toParameters(initial);
+    double scale = 1.0;
+    double bestError = 1e9;
+    for (double candidate = 10.0; candidate <= 1e9; candidate *= 1.25) {
+        double error = meanError(samples, 0, trainEnd, weights, candidate, options.threads);
+        if (error < bestError) {
+            bestError = error;
+            scale = candidate;
+        }
+    }
+    double startValidation = meanError(samples, trainEnd, samples.size(), weights, scale, options.threads);
+    std::cerr << "scale " << scale << ", error " << bestError << " (validation " << startValidation << ")" << std::endl;
+
+    // Multiplicative local search: nudge each weight up and down, keep any
+    // change that lowers the training error, and refine the step once no
+    // weight moves. A six is a finished game, so its weight stays put, and
+    // stronger patterns must keep scoring at least as much as weaker ones.
+    for (double step = 0.5; step >= 0.01; step /= 2) {
+        bool improved = true;
+        while (improved) {
+            improved = false;
+            for (int f = 0; f < PARAMETERS; ++f) {
+                if (f == PatternWeights::SIX) continue;
+                for (double factor : {1.0 + step, 1.0 / (1.0 + step)}) {
+                    Parameters candidate = weights;
+                    candidate[f] = std::max(1.0, weights[f] * factor);
+                    if (!isOrdered(candidate)) continue;
+                    double error = meanError(samples, 0, trainEnd, candidate, scale, options.threads);
+                    if (error < bestError) {
+                        bestError = error;
+                        weights = candidate;
+                        improved = true;
+                        break;
+                    }
+                }
+            }
+        }
+        std::cerr << "step " << step << ": error " << bestError << std::endl;
+    }
+
+    PatternWeights tuned = toWeights(weights);
+    double endValidation = meanError(samples, trainEnd, samples.size(), toParameters(tuned), scale, options.threads);
+    std::cerr << "validation error " << startValidation << " -> " << endValidation << std::endl;
+
+    if (!tuned.save(options.out)) {
+        std::cerr << "failed to write " << options.out << std::endl;
+        return 1;
+    }
+    std::cerr << "wrote " << options.out << std::endl;
+
+    if (options.matchGames > 0) {
+        double points = playMatch(options, tuned, initial);
+        std::cerr << "tuned vs initial: " << points << " / " << options.matchGames << std::endl;
+    }
+    return 0;
+}